@@ -0,0 +1,238 @@
+#include "batch_scheduler.h"
+#include "logger.h"
+#include "csv_format.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <sstream>
+#include <thread>
+
+namespace RoofOutline {
+
+BatchScheduler::BatchScheduler(const CostModel& model, int worker_count)
+    : model_(model)
+    , worker_count_(worker_count)
+{
+    if (worker_count_ <= 0) {
+        worker_count_ = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+}
+
+double BatchScheduler::predictMakespan(const std::vector<double>& predicted_totals) const {
+    // 最小堆保存各线程的累计负载，每个任务交给当前负载最小的线程
+    std::priority_queue<double, std::vector<double>, std::greater<double>> loads;
+    for (int i = 0; i < worker_count_; ++i) {
+        loads.push(0.0);
+    }
+
+    double makespan = 0.0;
+    for (double cost : predicted_totals) {
+        double load = loads.top() + cost;
+        loads.pop();
+        loads.push(load);
+        makespan = std::max(makespan, load);
+    }
+    return makespan;
+}
+
+std::vector<JobReport> BatchScheduler::run(const std::vector<BatchJob>& jobs, const Processor& processor) const {
+    std::vector<JobReport> reports(jobs.size());
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        reports[i].building_id = jobs[i].building_id;
+        reports[i].features = CostModel::extractFeatures(jobs[i].polygon);
+        reports[i].predicted = model_.predict(reports[i].features);
+    }
+
+    // 按预测总耗时从长到短排列
+    std::vector<size_t> order(jobs.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&reports](size_t a, size_t b) {
+        return reports[a].predicted.total() > reports[b].predicted.total();
+    });
+
+    std::vector<double> predicted_totals;
+    predicted_totals.reserve(order.size());
+    for (size_t index : order) {
+        predicted_totals.push_back(reports[index].predicted.total());
+    }
+    double predicted_makespan = predictMakespan(predicted_totals);
+
+    int workers = std::min(worker_count_, std::max(1, static_cast<int>(jobs.size())));
+    ROOF_LOG_INFO("batch", "开始批处理：%zu 个任务，%d 个工作线程%s", jobs.size(), workers,
+                  model_.isCalibrated() ? "" : "（耗时模型未校准）");
+
+    auto batch_start = std::chrono::steady_clock::now();
+    auto elapsed_ms = [batch_start]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - batch_start).count();
+    };
+
+    std::atomic<size_t> next{0};
+    auto work = [&](int worker) {
+        for (size_t k = next.fetch_add(1); k < order.size(); k = next.fetch_add(1)) {
+            size_t index = order[k];
+            const BatchJob& job = jobs[index];
+            JobReport& report = reports[index];
+
+            LogContext log_context(job.building_id);
+            report.worker = worker;
+            report.start_ms = elapsed_ms();
+            report.success = processor(index, job, report.actual);
+            report.finish_ms = elapsed_ms();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < workers; ++i) {
+        threads.emplace_back(work, i);
+    }
+    work(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    double actual_makespan = 0.0;
+    size_t failures = 0;
+    for (const auto& report : reports) {
+        actual_makespan = std::max(actual_makespan, report.finish_ms);
+        if (!report.success) {
+            failures++;
+        }
+    }
+
+    ROOF_LOG_INFO("batch", "批处理完成：预测总耗时 %.2fms，实际总耗时 %.2fms，失败 %zu 个",
+                  predicted_makespan, actual_makespan, failures);
+    logPredictionQuality(reports);
+    return reports;
+}
+
+void BatchScheduler::logPredictionQuality(const std::vector<JobReport>& reports) {
+    double error[4] = {0.0, 0.0, 0.0, 0.0};
+    size_t count = 0;
+    for (const auto& report : reports) {
+        if (!report.success) {
+            continue;
+        }
+        const double predicted[4] = {report.predicted.skeleton_ms, report.predicted.unfold_ms,
+                                     report.predicted.render_ms, report.predicted.offset_ms};
+        const double actual[4] = {report.actual.skeleton_ms, report.actual.unfold_ms,
+                                  report.actual.render_ms, report.actual.offset_ms};
+        for (int i = 0; i < 4; ++i) {
+            // 极短的阶段按 0.01ms 计，避免百分比误差被放大
+            error[i] += std::abs(predicted[i] - actual[i]) / std::max(actual[i], 0.01);
+        }
+        count++;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    ROOF_LOG_INFO("batch", "预测平均绝对百分比误差：直骨架 %.1f%%，展开 %.1f%%，渲染 %.1f%%，偏移轮廓 %.1f%%",
+                  100.0 * error[0] / count, 100.0 * error[1] / count, 100.0 * error[2] / count,
+                  100.0 * error[3] / count);
+}
+
+bool BatchScheduler::writeReport(const std::string& filename, const std::vector<JobReport>& reports) {
+    std::ofstream csv(filename);
+    if (!csv) {
+        ROOF_LOG_ERROR("batch", "无法创建调度报告文件: %s", filename.c_str());
+        return false;
+    }
+    CsvFormat::setFullPrecision(csv);
+
+    csv << "building_id,success,worker,start_ms,finish_ms,vertex_count,reflex_count,collinear_count,aspect_ratio,"
+        << "predicted_skeleton_ms,actual_skeleton_ms,predicted_unfold_ms,actual_unfold_ms,"
+        << "predicted_render_ms,actual_render_ms,predicted_offset_ms,actual_offset_ms,"
+        << "predicted_total_ms,actual_total_ms,"
+        << "repair_duplicate_vertices,repair_spikes,repair_intersections,repair_discarded_rings,repair_discarded_area\n";
+
+    for (const auto& report : reports) {
+        csv << CsvFormat::quote(report.building_id) << ","
+            << (report.success ? 1 : 0) << ","
+            << report.worker << ","
+            << report.start_ms << ","
+            << report.finish_ms << ","
+            << report.features.vertex_count << ","
+            << report.features.reflex_count << ","
+            << report.features.collinear_count << ","
+            << report.features.aspect_ratio << ","
+            << report.predicted.skeleton_ms << ","
+            << report.actual.skeleton_ms << ","
+            << report.predicted.unfold_ms << ","
+            << report.actual.unfold_ms << ","
+            << report.predicted.render_ms << ","
+            << report.actual.render_ms << ","
+            << report.predicted.offset_ms << ","
+            << report.actual.offset_ms << ","
+            << report.predicted.total() << ","
+            << report.actual.total() << ","
+            << report.repair.duplicate_vertices << ","
+            << report.repair.spikes << ","
+            << report.repair.intersections << ","
+            << report.repair.discarded_rings << ","
+            << report.repair.discarded_area << "\n";
+    }
+
+    csv.close();
+    ROOF_LOG_INFO("batch", "✓ 调度报告已生成: %s", filename.c_str());
+    return true;
+}
+
+bool BatchScheduler::loadFootprints(const std::string& filename, std::vector<BatchJob>& jobs) {
+    std::ifstream input(filename);
+    if (!input) {
+        ROOF_LOG_ERROR("batch", "无法打开轮廓列表文件: %s", filename.c_str());
+        return false;
+    }
+
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(input, line)) {
+        ++line_number;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::istringstream tokens(line);
+        BatchJob job;
+        if (!(tokens >> job.building_id)) {
+            continue;
+        }
+
+        std::string token;
+        bool valid = true;
+        while (tokens >> token) {
+            size_t comma = token.find(',');
+            if (comma == std::string::npos) {
+                valid = false;
+                break;
+            }
+            char* end_x = nullptr;
+            char* end_y = nullptr;
+            double x = std::strtod(token.c_str(), &end_x);
+            double y = std::strtod(token.c_str() + comma + 1, &end_y);
+            if (end_x != token.c_str() + comma || end_y == token.c_str() + comma + 1) {
+                valid = false;
+                break;
+            }
+            job.polygon.push_back(Point(x, y));
+        }
+
+        if (!valid || job.polygon.size() < 3) {
+            ROOF_LOG_WARNING("batch", "警告：轮廓列表第 %zu 行格式错误，已跳过", line_number);
+            continue;
+        }
+        jobs.push_back(std::move(job));
+    }
+
+    ROOF_LOG_INFO("batch", "读取 %zu 个建筑轮廓: %s", jobs.size(), filename.c_str());
+    return true;
+}
+
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "types.h"
+#include "cost_model.h"
+#include "polygon_repair.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace RoofOutline {
+
+/**
+ * 一栋建筑的处理任务
+ */
+struct BatchJob {
+    std::string building_id;
+    Polygon_2 polygon;
+};
+
+/**
+ * 单个任务的调度结果
+ */
+struct JobReport {
+    std::string building_id;
+    FootprintFeatures features;
+    StageTimes predicted;       // 模型预测耗时
+    StageTimes actual;          // 实际耗时
+    RepairReport repair;        // 轮廓修复记录
+    int worker = -1;            // 执行该任务的工作线程
+    double start_ms = 0.0;      // 相对批处理开始的开始时间
+    double finish_ms = 0.0;     // 相对批处理开始的结束时间
+    bool success = false;
+};
+
+/**
+ * 批处理调度模块
+ * 按预测耗时从长到短（LPT）排列任务，空闲的工作线程依次领取下一个任务，
+ * 等价于把每个任务分配给当前负载最小的线程，避免大任务排在最后拖长总耗时
+ */
+class BatchScheduler {
+public:
+    /**
+     * 单个任务的处理函数：index 为任务在 jobs 中的下标，返回是否成功，并填写各阶段实际耗时
+     */
+    typedef std::function<bool(size_t index, const BatchJob& job, StageTimes& actual)> Processor;
+
+    /**
+     * 构造函数
+     * @param model 耗时预测模型
+     * @param worker_count 工作线程数（<= 0 时使用硬件并发数）
+     */
+    BatchScheduler(const CostModel& model, int worker_count);
+
+    /**
+     * 执行批处理
+     * @param jobs 任务列表
+     * @param processor 处理函数（会在多个线程中并发调用）
+     * @return 每个任务的结果，顺序与 jobs 一致
+     */
+    std::vector<JobReport> run(const std::vector<BatchJob>& jobs, const Processor& processor) const;
+
+    /**
+     * 按 LPT 规则模拟分配，返回预测的总耗时（毫秒）
+     * @param predicted_totals 各任务预测耗时（已按从长到短排序）
+     */
+    double predictMakespan(const std::vector<double>& predicted_totals) const;
+
+    /**
+     * 输出预测与实际耗时对比 CSV
+     * @param filename 输出文件名
+     * @param reports 任务结果
+     * @return 是否成功
+     */
+    static bool writeReport(const std::string& filename, const std::vector<JobReport>& reports);
+
+    /**
+     * 读取轮廓列表文件：每行 "建筑标识 x1,y1 x2,y2 ..."，空行和 # 开头的行忽略
+     * @param filename 文件名
+     * @param jobs 追加读到的任务
+     * @return 是否成功
+     */
+    static bool loadFootprints(const std::string& filename, std::vector<BatchJob>& jobs);
+
+private:
+    const CostModel& model_;
+    int worker_count_;
+
+    /**
+     * 记录预测质量（各阶段平均绝对百分比误差）
+     */
+    static void logPredictionQuality(const std::vector<JobReport>& reports);
+};
+
+}
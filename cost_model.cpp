@@ -0,0 +1,266 @@
+#include "cost_model.h"
+#include "logger.h"
+#include "csv_format.h"
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <fstream>
+
+namespace RoofOutline {
+
+CostModel::CostModel()
+    // 默认系数只需给出合理的相对大小，保证未校准时也能大致按规模排序
+    : skeleton_coefficients_{{0.05, 0.002, 0.0005, 0.01, 0.0002, 0.0, 0.0}}
+    , unfold_coefficients_{{0.02, 0.004, 0.0002, 0.0, 0.0, 0.0, 0.0}}
+    , render_coefficients_{{0.5, 0.01, 0.0, 0.0, 0.0, 0.0, 0.0}}
+    , offset_coefficients_{{0.05, 0.002, 0.0005, 0.01, 0.0002, 0.0, 0.0}}
+{
+}
+
+FootprintFeatures CostModel::extractFeatures(const Polygon_2& polygon) {
+    FootprintFeatures features;
+    size_t n = polygon.size();
+    features.vertex_count = static_cast<int>(n);
+    if (n < 3) {
+        return features;
+    }
+
+    // 凹凸判断需要知道整体方向
+    double twice_area = 0.0;
+    double min_x = polygon[0].x(), max_x = min_x;
+    double min_y = polygon[0].y(), max_y = min_y;
+    for (size_t i = 0; i < n; ++i) {
+        const Point& p = polygon[i];
+        const Point& q = polygon[(i + 1) % n];
+        twice_area += p.x() * q.y() - q.x() * p.y();
+        min_x = std::min(min_x, p.x());
+        max_x = std::max(max_x, p.x());
+        min_y = std::min(min_y, p.y());
+        max_y = std::max(max_y, p.y());
+    }
+    double orientation = twice_area >= 0 ? 1.0 : -1.0;
+
+    for (size_t i = 0; i < n; ++i) {
+        const Point& a = polygon[(i + n - 1) % n];
+        const Point& b = polygon[i];
+        const Point& c = polygon[(i + 1) % n];
+        double ux = b.x() - a.x(), uy = b.y() - a.y();
+        double vx = c.x() - b.x(), vy = c.y() - b.y();
+        double cross = (ux * vy - uy * vx) * orientation;
+        double scale = std::sqrt((ux * ux + uy * uy) * (vx * vx + vy * vy));
+
+        if (std::abs(cross) <= 1e-9 * scale) {
+            features.collinear_count++;
+        } else if (cross < 0) {
+            features.reflex_count++;
+        }
+    }
+
+    double width = max_x - min_x;
+    double height = max_y - min_y;
+    double shorter = std::min(width, height);
+    features.aspect_ratio = shorter > 0 ? std::max(width, height) / shorter : 1.0;
+    return features;
+}
+
+CostModel::Terms CostModel::terms(const FootprintFeatures& features) {
+    double n = features.vertex_count;
+    double r = features.reflex_count;
+    return {{1.0, n, n * std::log2(n + 1.0), r, r * n, features.aspect_ratio,
+             static_cast<double>(features.collinear_count)}};
+}
+
+StageTimes CostModel::predict(const FootprintFeatures& features) const {
+    Terms x = terms(features);
+    auto evaluate = [&x](const Terms& coefficients) {
+        double value = 0.0;
+        for (size_t i = 0; i < kTermCount; ++i) {
+            value += coefficients[i] * x[i];
+        }
+        return std::max(0.0, value);
+    };
+
+    StageTimes times;
+    times.skeleton_ms = evaluate(skeleton_coefficients_);
+    times.unfold_ms = evaluate(unfold_coefficients_);
+    times.render_ms = evaluate(render_coefficients_);
+    times.offset_ms = evaluate(offset_coefficients_);
+    return times;
+}
+
+bool CostModel::fit(const std::vector<Terms>& rows, const std::vector<double>& values, Terms& coefficients) {
+    // 按相对误差拟合：每条记录以 1/实际耗时 加权，避免大任务主导、小任务的预测严重偏离
+    std::vector<double> weights(rows.size());
+    for (size_t k = 0; k < rows.size(); ++k) {
+        weights[k] = 1.0 / std::max(values[k], 0.01);
+    }
+
+    // 各项量级差别很大：先按列均方根缩放，再解带岭正则的正规方程
+    Terms scale{};
+    for (size_t k = 0; k < rows.size(); ++k) {
+        for (size_t i = 0; i < kTermCount; ++i) {
+            double x = rows[k][i] * weights[k];
+            scale[i] += x * x;
+        }
+    }
+    for (size_t i = 0; i < kTermCount; ++i) {
+        scale[i] = scale[i] > 0 ? std::sqrt(scale[i] / rows.size()) : 1.0;
+    }
+
+    double matrix[kTermCount][kTermCount + 1] = {};
+    for (size_t k = 0; k < rows.size(); ++k) {
+        for (size_t i = 0; i < kTermCount; ++i) {
+            double w = weights[k];
+            double xi = rows[k][i] * w / scale[i];
+            for (size_t j = 0; j < kTermCount; ++j) {
+                matrix[i][j] += xi * rows[k][j] * w / scale[j];
+            }
+            matrix[i][kTermCount] += xi * values[k] * w;
+        }
+    }
+    double ridge = 1e-6 * rows.size();
+    for (size_t i = 0; i < kTermCount; ++i) {
+        matrix[i][i] += ridge;
+    }
+
+    // 列主元高斯消元
+    for (size_t col = 0; col < kTermCount; ++col) {
+        size_t pivot = col;
+        for (size_t row = col + 1; row < kTermCount; ++row) {
+            if (std::abs(matrix[row][col]) > std::abs(matrix[pivot][col])) {
+                pivot = row;
+            }
+        }
+        if (std::abs(matrix[pivot][col]) < 1e-12) {
+            return false;
+        }
+        if (pivot != col) {
+            for (size_t j = 0; j <= kTermCount; ++j) {
+                std::swap(matrix[col][j], matrix[pivot][j]);
+            }
+        }
+        for (size_t row = 0; row < kTermCount; ++row) {
+            if (row == col) {
+                continue;
+            }
+            double factor = matrix[row][col] / matrix[col][col];
+            for (size_t j = col; j <= kTermCount; ++j) {
+                matrix[row][j] -= factor * matrix[col][j];
+            }
+        }
+    }
+
+    for (size_t i = 0; i < kTermCount; ++i) {
+        coefficients[i] = matrix[i][kTermCount] / matrix[i][i] / scale[i];
+    }
+    return true;
+}
+
+bool CostModel::calibrate(const std::vector<TraceRecord>& records) {
+    if (records.size() < kTermCount + 1) {
+        ROOF_LOG_INFO("cost", "耗时记录不足（%zu 条），使用默认耗时模型", records.size());
+        return false;
+    }
+
+    std::vector<Terms> rows;
+    std::vector<double> skeleton, unfold, render, offset;
+    rows.reserve(records.size());
+    for (const auto& record : records) {
+        rows.push_back(terms(record.features));
+        skeleton.push_back(record.times.skeleton_ms);
+        unfold.push_back(record.times.unfold_ms);
+        render.push_back(record.times.render_ms);
+        offset.push_back(record.times.offset_ms);
+    }
+
+    Terms skeleton_fit, unfold_fit, render_fit, offset_fit;
+    if (!fit(rows, skeleton, skeleton_fit) ||
+        !fit(rows, unfold, unfold_fit) ||
+        !fit(rows, render, render_fit) ||
+        !fit(rows, offset, offset_fit)) {
+        ROOF_LOG_WARNING("cost", "警告：耗时模型拟合失败，使用默认耗时模型");
+        return false;
+    }
+
+    skeleton_coefficients_ = skeleton_fit;
+    unfold_coefficients_ = unfold_fit;
+    render_coefficients_ = render_fit;
+    offset_coefficients_ = offset_fit;
+    calibrated_ = true;
+    ROOF_LOG_INFO("cost", "耗时模型已由 %zu 条记录校准", records.size());
+    return true;
+}
+
+bool CostModel::loadTrace(const std::string& filename, std::vector<TraceRecord>& records) {
+    std::ifstream trace(filename);
+    if (!trace) {
+        return false;
+    }
+
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(trace, line)) {
+        ++line_number;
+        if (line.empty() || line.compare(0, 11, "building_id") == 0) {
+            continue;
+        }
+
+        std::vector<std::string> fields;
+        std::vector<double> numbers;
+        bool well_formed = CsvFormat::split(line, fields);
+        for (size_t i = 1; well_formed && i < fields.size(); ++i) {
+            char* end = nullptr;
+            double number = std::strtod(fields[i].c_str(), &end);
+            if (end == fields[i].c_str()) {
+                break;
+            }
+            numbers.push_back(number);
+        }
+        if (!well_formed || (numbers.size() != 7 && numbers.size() != 8)) {
+            ROOF_LOG_WARNING("cost", "警告：耗时记录第 %zu 行格式错误，已跳过", line_number);
+            continue;
+        }
+
+        TraceRecord record;
+        record.building_id = fields[0];
+        record.features.vertex_count = static_cast<int>(numbers[0]);
+        record.features.reflex_count = static_cast<int>(numbers[1]);
+        record.features.collinear_count = static_cast<int>(numbers[2]);
+        record.features.aspect_ratio = numbers[3];
+        record.times.skeleton_ms = numbers[4];
+        record.times.unfold_ms = numbers[5];
+        record.times.render_ms = numbers[6];
+        record.times.offset_ms = numbers.size() > 7 ? numbers[7] : 0.0;
+        records.push_back(record);
+    }
+    return true;
+}
+
+bool CostModel::appendTrace(const std::string& filename, const std::vector<TraceRecord>& records) {
+    bool exists = static_cast<bool>(std::ifstream(filename));
+    std::ofstream trace(filename, std::ios::app);
+    if (!trace) {
+        ROOF_LOG_ERROR("cost", "无法写入耗时记录文件: %s", filename.c_str());
+        return false;
+    }
+    CsvFormat::setFullPrecision(trace);
+
+    if (!exists) {
+        trace << "building_id,vertex_count,reflex_count,collinear_count,aspect_ratio,"
+              << "skeleton_ms,unfold_ms,render_ms,offset_ms\n";
+    }
+    for (const auto& record : records) {
+        trace << CsvFormat::quote(record.building_id) << ","
+              << record.features.vertex_count << ","
+              << record.features.reflex_count << ","
+              << record.features.collinear_count << ","
+              << record.features.aspect_ratio << ","
+              << record.times.skeleton_ms << ","
+              << record.times.unfold_ms << ","
+              << record.times.render_ms << ","
+              << record.times.offset_ms << "\n";
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "types.h"
+#include <array>
+#include <string>
+#include <vector>
+
+namespace RoofOutline {
+
+/**
+ * 轮廓的廉价特征（无需计算直骨架即可得到）
+ */
+struct FootprintFeatures {
+    int vertex_count = 0;       // 顶点数
+    int reflex_count = 0;       // 凹顶点数
+    int collinear_count = 0;    // 相邻两边共线的顶点数
+    double aspect_ratio = 1.0;  // 包围盒长宽比（>= 1）
+};
+
+/**
+ * 各处理阶段耗时（毫秒）
+ */
+struct StageTimes {
+    double skeleton_ms = 0.0;   // 直骨架
+    double unfold_ms = 0.0;     // 展开与排布
+    double render_ms = 0.0;     // 渲染与输出
+    double offset_ms = 0.0;     // 偏移轮廓（内缩线与挑檐线）
+
+    double total() const { return skeleton_ms + unfold_ms + render_ms + offset_ms; }
+};
+
+/**
+ * 一条耗时记录（一栋建筑的特征与实际耗时）
+ */
+struct TraceRecord {
+    std::string building_id;
+    FootprintFeatures features;
+    StageTimes times;
+};
+
+/**
+ * 耗时预测模型
+ * 每个阶段的耗时用轮廓特征的线性组合（含 n·log n、凹顶点数×顶点数等项）近似，
+ * 系数由以往运行的耗时记录通过带正则的最小二乘拟合得到；没有足够记录时使用保守的默认系数
+ */
+class CostModel {
+public:
+    CostModel();
+
+    /**
+     * 提取轮廓特征
+     * @param polygon 输入多边形（任意方向）
+     * @return 特征
+     */
+    static FootprintFeatures extractFeatures(const Polygon_2& polygon);
+
+    /**
+     * 预测各阶段耗时
+     * @param features 轮廓特征
+     * @return 预测耗时（毫秒，非负）
+     */
+    StageTimes predict(const FootprintFeatures& features) const;
+
+    /**
+     * 用耗时记录拟合模型系数
+     * @param records 耗时记录
+     * @return 是否完成拟合（记录不足时保持原系数并返回 false）
+     */
+    bool calibrate(const std::vector<TraceRecord>& records);
+
+    /**
+     * 是否已由耗时记录校准
+     */
+    bool isCalibrated() const { return calibrated_; }
+
+    /**
+     * 读取耗时记录文件（CSV），文件不存在时返回 false 且不修改 records
+     * 兼容没有 offset_ms 列的旧记录（偏移轮廓耗时记为 0）
+     * @param filename 文件名
+     * @param records 追加读到的记录
+     * @return 是否成功读取
+     */
+    static bool loadTrace(const std::string& filename, std::vector<TraceRecord>& records);
+
+    /**
+     * 向耗时记录文件（CSV）追加记录，文件不存在时创建并写入表头
+     * @param filename 文件名
+     * @param records 待追加的记录
+     * @return 是否成功
+     */
+    static bool appendTrace(const std::string& filename, const std::vector<TraceRecord>& records);
+
+private:
+    static const size_t kTermCount = 7;
+    typedef std::array<double, kTermCount> Terms;
+
+    /**
+     * 由特征展开回归项：1, n, n·log2(n), r, r·n, 长宽比, 共线顶点数
+     */
+    static Terms terms(const FootprintFeatures& features);
+
+    /**
+     * 拟合单个阶段的系数
+     */
+    static bool fit(const std::vector<Terms>& rows, const std::vector<double>& values, Terms& coefficients);
+
+    Terms skeleton_coefficients_;
+    Terms unfold_coefficients_;
+    Terms render_coefficients_;
+    Terms offset_coefficients_;
+    bool calibrated_ = false;
+};
+
+}
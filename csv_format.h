@@ -0,0 +1,37 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace RoofOutline {
+
+/**
+ * CSV 格式辅助（RFC 4180）
+ * 各输出模块共用：字段中含逗号、双引号或换行时加双引号并把双引号写为两个，数值列按完整精度输出
+ */
+class CsvFormat {
+public:
+    /**
+     * 按 RFC 4180 转义一个字段
+     * @param field 原始字段
+     * @return 可直接写入 CSV 的字段
+     */
+    static std::string quote(const std::string& field);
+
+    /**
+     * 按 RFC 4180 拆分一行（不支持字段内换行）
+     * @param line 一行文本（不含行尾换行）
+     * @param fields 输出字段（已去掉引号与转义）
+     * @return 引号是否配对
+     */
+    static bool split(const std::string& line, std::vector<std::string>& fields);
+
+    /**
+     * 设置流的浮点输出精度，使 double 读回后与原值完全相同
+     * @param stream 输出流
+     */
+    static void setFullPrecision(std::ostream& stream);
+};
+
+}
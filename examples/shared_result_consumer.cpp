@@ -0,0 +1,83 @@
+// 共享内存结果消费者示例
+// 先启动本程序，再以 --shared-output <名称> 运行 roof_outline（或加 --batch 批处理）。
+// 本程序不依赖 CGAL，只需与 shared_result_reader.cpp、shared_ring.cpp、logger.cpp 一起编译：
+//   MSVC:  cl /std:c++17 /EHsc /utf-8 /I.. shared_result_consumer.cpp ..\shared_result_reader.cpp ..\shared_ring.cpp ..\logger.cpp
+//   Linux: g++ -std=c++17 -O2 -I.. shared_result_consumer.cpp ../shared_result_reader.cpp ../shared_ring.cpp ../logger.cpp -lpthread -lrt
+
+#include "shared_result_reader.h"
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+using namespace RoofOutline;
+
+int main(int argc, char* argv[])
+{
+	// 用法：shared_result_consumer <名称> [结果数，0 为一直读取]
+	if (argc < 2) {
+		std::printf("usage: %s <name> [count]\n", argv[0]);
+		return 1;
+	}
+	std::string name = argv[1];
+	long limit = argc > 2 ? std::atol(argv[2]) : 0;
+
+	struct LogFlusher {
+		~LogFlusher() { Logger::instance().flush(); }
+	} log_flusher;
+
+	SharedResultReader reader;
+	SharedResultView view;
+	long received = 0;
+	while (limit == 0 || received < limit) {
+		// 生产者尚未创建共享内存时等待其启动（生产者退出前会等待消费者读完）
+		if (!reader.isOpen()) {
+			if (!reader.open(name)) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+				continue;
+			}
+		}
+		if (!reader.next(view, 30000)) {
+			if (reader.corrupted()) {
+				break;
+			}
+			if (reader.producerClosed()) {
+				// 本次运行的结果已读完，等待生产者下一次运行
+				reader.close();
+				continue;
+			}
+			// 超时：一直读取时继续等待，指定了结果数时结束
+			if (limit == 0) {
+				continue;
+			}
+			break;
+		}
+
+		// 所有数据都在共享内存中原地读取，不做复制
+		double max_height = 0.0;
+		for (uint32_t i = 0; i < view.vertex_count; ++i) {
+			max_height = std::max(max_height, view.vertices[3 * i + 2]);
+		}
+		uint32_t gray_faces = 0;
+		for (uint32_t i = 0; i < view.face_count; ++i) {
+			gray_faces += view.face_gray[i];
+		}
+
+		std::printf("#%llu %.*s: %u vertices, %u faces (%u gray), max height %.3f, %u unfolded faces, svg %u + %u bytes\n",
+			static_cast<unsigned long long>(view.sequence),
+			static_cast<int>(view.building_id_bytes), view.building_id,
+			view.vertex_count, view.face_count, gray_faces, max_height,
+			view.unfolded_face_count, view.ridge_svg_bytes, view.unfolded_svg_bytes);
+		std::fflush(stdout);
+
+		reader.release();
+		received++;
+	}
+
+	std::printf("received %ld results, producer dropped %llu\n", received,
+		static_cast<unsigned long long>(reader.dropped()));
+	return 0;
+}
@@ -1,19 +1,30 @@
 #include "geometry.h"
-#include <iostream>
+#include "logger.h"
+#include "rectilinear_skeleton.h"
 #include <algorithm>
+#include <cmath>
 
 namespace RoofOutline {
 
-bool Geometry::validateAndFixPolygon(Polygon_2& polygon) {
+bool Geometry::validateAndFixPolygon(Polygon_2& polygon, RepairReport& report) {
+    // 修复重复顶点、尖刺和自交
+    if (!PolygonRepair::repair(polygon, report)) {
+        ROOF_LOG_ERROR("validate", "错误：多边形修复后已退化，无法处理！");
+        return false;
+    }
+    if (report.changed()) {
+        ROOF_LOG_WARNING("validate", "多边形已修复：%s", report.summary().c_str());
+    }
+
     // 检查多边形方向
     if (polygon.is_clockwise_oriented()) {
         polygon.reverse_orientation();
-        std::cout << "多边形已转换为逆时针方向" << std::endl;
+        ROOF_LOG_INFO("validate", "多边形已转换为逆时针方向");
     }
 
     // 检查多边形是否自交
     if (!polygon.is_simple()) {
-        std::cerr << "错误：多边形存在自交！" << std::endl;
+        ROOF_LOG_ERROR("validate", "错误：多边形修复后仍存在自交！");
         return false;
     }
 
@@ -21,16 +32,53 @@ bool Geometry::validateAndFixPolygon(Polygon_2& polygon) {
 }
 
 SsPtr Geometry::createInteriorSkeleton(const Polygon_2& polygon) {
-    std::cout << "正在计算内部直骨架（屋脊线）..." << std::endl;
-    SsPtr skeleton = CGAL::create_interior_straight_skeleton_2(polygon);
+    ROOF_LOG_INFO("skeleton", "正在计算内部直骨架（屋脊线）...");
+    SsPtr skeleton;
+
+    // 正交多边形使用专用算法，失败时回退到 CGAL
+    double rotation = 0.0;
+    if (RectilinearSkeleton::isRectilinear(polygon, rotation)) {
+        skeleton = RectilinearSkeleton::create(polygon);
+        if (skeleton) {
+            ROOF_LOG_DEBUG("skeleton", "使用正交多边形直骨架算法（旋转角 %g）", rotation);
+#if defined(ROOF_OUTLINE_VERIFY_RECTILINEAR_SKELETON)
+            // 与 CGAL 结果交叉校验（回归测试见 tests/rectilinear_skeleton_test），不一致时采用 CGAL 的结果
+            SsPtr reference = CGAL::create_interior_straight_skeleton_2(polygon);
+            double min_x, max_x, min_y, max_y;
+            calculateBoundingBox(polygon, min_x, max_x, min_y, max_y, 0.0);
+            double tolerance = 1e-6 * std::max(1.0, std::max(max_x - min_x, max_y - min_y));
+            if (reference && !RectilinearSkeleton::sameTopology(skeleton, reference, tolerance)) {
+                ROOF_LOG_WARNING("skeleton", "警告：正交多边形直骨架与 CGAL 结果不一致，改用 CGAL 结果");
+                skeleton = reference;
+            }
+#endif
+        } else {
+            ROOF_LOG_WARNING("skeleton", "警告：正交多边形直骨架计算失败，回退到 CGAL");
+        }
+    }
+
+    if (!skeleton) {
+        skeleton = CGAL::create_interior_straight_skeleton_2(polygon);
+    }
     
     if (!skeleton) {
-        std::cerr << "错误：无法创建直骨架！" << std::endl;
+        ROOF_LOG_ERROR("skeleton", "错误：无法创建直骨架！");
     }
     
     return skeleton;
 }
 
+SsPtr Geometry::createExteriorSkeleton(const Polygon_2& polygon, double max_offset) {
+    ROOF_LOG_INFO("skeleton", "正在计算外部直骨架（最大偏移 %g）...", max_offset);
+    SsPtr skeleton = CGAL::create_exterior_straight_skeleton_2(max_offset, polygon);
+
+    if (!skeleton) {
+        ROOF_LOG_ERROR("skeleton", "错误：无法创建外部直骨架！");
+    }
+
+    return skeleton;
+}
+
 void Geometry::calculateBoundingBox(
     const Polygon_2& polygon,
     double& min_x, double& max_x,
@@ -81,11 +129,30 @@ bool Geometry::findCenterVertex(
     }
     
     if (found) {
-        std::cout << "中心顶点坐标: (" << center_x << ", " << center_y 
-                  << "), 时间值: " << max_time << std::endl;
+        ROOF_LOG_INFO("skeleton", "中心顶点坐标: (%g, %g), 时间值: %g", center_x, center_y, max_time);
     }
     
     return found;
 }
 
+
+bool Geometry::containsGrayVertex(
+    const std::vector<std::pair<double, double>>& face_vertices,
+    const std::vector<std::pair<double, double>>& gray_vertices
+) {
+    int match_count = 0;
+    double epsilon = 0.5;
+
+    for (const auto& fv : face_vertices) {
+        for (const auto& gv : gray_vertices) {
+            if (std::abs(fv.first - gv.first) < epsilon &&
+                std::abs(fv.second - gv.second) < epsilon) {
+                match_count++;
+                break;
+            }
+        }
+    }
+    return match_count >= 3; // 至少包含3个指定顶点才填充灰色
+}
+
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "types.h"
+#include "polygon_repair.h"
+#include <utility>
 #include <vector>
 
 namespace RoofOutline {
@@ -12,11 +14,12 @@ namespace RoofOutline {
 class Geometry {
 public:
     /**
-     * 验证并修正多边形方向
+     * 验证并修正多边形（修复重复顶点、尖刺和自交，并统一为逆时针方向）
      * @param polygon 输入多边形
+     * @param report 输出修复记录
      * @return true if valid, false otherwise
      */
-    static bool validateAndFixPolygon(Polygon_2& polygon);
+    static bool validateAndFixPolygon(Polygon_2& polygon, RepairReport& report);
 
     /**
      * 创建内部直骨架
@@ -25,6 +28,14 @@ public:
      */
     static SsPtr createInteriorSkeleton(const Polygon_2& polygon);
 
+    /**
+     * 创建外部直骨架（用于挑檐等向外偏移，每个轮廓只需创建一次）
+     * @param polygon 输入多边形
+     * @param max_offset 需要支持的最大向外偏移距离
+     * @return 直骨架智能指针
+     */
+    static SsPtr createExteriorSkeleton(const Polygon_2& polygon, double max_offset);
+
     /**
      * 计算多边形的边界框
      * @param polygon 输入多边形
@@ -51,6 +62,17 @@ public:
         double& center_y,
         double& max_time
     );
+
+    /**
+     * 检查面是否包含灰色顶点（至少3个面顶点与灰色顶点重合，容差0.5）
+     * @param face_vertices 面顶点（与灰色顶点使用同一坐标系）
+     * @param gray_vertices 需要标记为灰色的特殊顶点
+     * @return 是否为灰色面
+     */
+    static bool containsGrayVertex(
+        const std::vector<std::pair<double, double>>& face_vertices,
+        const std::vector<std::pair<double, double>>& gray_vertices
+    );
 };
 
 } 
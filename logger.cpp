@@ -0,0 +1,336 @@
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace RoofOutline {
+
+namespace {
+
+int64_t nowMicroseconds() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+thread_local std::string t_building_id;
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+    case LogLevel::Debug:
+        return "DEBUG";
+    case LogLevel::Info:
+        return "INFO";
+    case LogLevel::Warning:
+        return "WARN";
+    case LogLevel::Error:
+        return "ERROR";
+    }
+    return "?";
+}
+
+}
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : start_time_us_(nowMicroseconds())
+{
+    running_ = true;
+    worker_ = std::thread(&Logger::run, this);
+}
+
+Logger::~Logger() {
+    shutdown();
+}
+
+void Logger::setBuildingId(const std::string& building_id) {
+    t_building_id = building_id;
+}
+
+const std::string& Logger::buildingId() {
+    return t_building_id;
+}
+
+Logger::RingLease::~RingLease() {
+    if (ring) {
+        ring->in_use.store(false, std::memory_order_release);
+    }
+}
+
+Logger::Ring* Logger::threadRing() {
+    thread_local RingLease lease;
+    if (!lease.ring) {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        // 复用已退出线程的缓冲区：生产者身份随之转交（in_use 的释放/获取保证旧线程的写入可见），
+        // 未输出的记录仍由后台线程照常取出，反复创建线程的批处理不会不断分配新缓冲区
+        for (const auto& ring : rings_) {
+            if (!ring->in_use.load(std::memory_order_acquire)) {
+                lease.ring = ring.get();
+                break;
+            }
+        }
+        if (!lease.ring) {
+            rings_.push_back(std::make_unique<Ring>());
+            lease.ring = rings_.back().get();
+        }
+        lease.ring->thread_index.store(next_thread_index_++, std::memory_order_relaxed);
+        lease.ring->in_use.store(true, std::memory_order_relaxed);
+    }
+    return lease.ring;
+}
+
+LogRecord* Logger::reserve(Ring* ring, LogLevel level, const char* stage, const char* format) {
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    uint64_t tail = ring->tail.load(std::memory_order_acquire);
+    if (head - tail >= kRingCapacity) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    // 发布前消费者不会读取该槽位
+    LogRecord& record = ring->records[head % kRingCapacity];
+    record.timestamp_us = nowMicroseconds() - start_time_us_;
+    record.level = level;
+    record.thread_index = ring->thread_index.load(std::memory_order_relaxed);
+    record.stage = stage;
+    record.format = format;
+
+    size_t id_length = std::min(t_building_id.size(), sizeof(record.building_id) - 1);
+    std::memcpy(record.building_id, t_building_id.data(), id_length);
+    record.building_id[id_length] = '\0';
+    return &record;
+}
+
+std::string Logger::formatMessage(const LogRecord& record) {
+    std::string message;
+    size_t offset = 0;
+
+    // 按记录中的类型标记取出下一个参数；没有剩余参数时返回 false
+    auto next = [&record, &offset](uint8_t& tag, uint64_t& bits, std::string& text) {
+        if (offset >= record.arg_bytes) {
+            return false;
+        }
+        tag = record.args[offset++];
+        if (tag == 's') {
+            uint16_t length = 0;
+            std::memcpy(&length, record.args + offset, sizeof(length));
+            text.assign(reinterpret_cast<const char*>(record.args + offset + sizeof(length)), length);
+            offset += sizeof(length) + length;
+        } else {
+            std::memcpy(&bits, record.args + offset, sizeof(bits));
+            offset += sizeof(bits);
+        }
+        return true;
+    };
+    auto as_integer = [](uint8_t tag, uint64_t bits) -> long long {
+        if (tag == 'd') {
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return static_cast<long long>(value);
+        }
+        return static_cast<long long>(bits);
+    };
+
+    char buffer[512];
+    const char* p = record.format;
+    while (*p) {
+        if (*p != '%') {
+            message += *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            message += '%';
+            p += 2;
+            continue;
+        }
+
+        // 解析一个转换说明：%[标志][宽度][.精度][长度]转换符；长度修饰在格式化时按参数的实际类型重写
+        std::string spec = "%";
+        const char* q = p + 1;
+        std::vector<int> stars;
+        bool missing = false;
+        while (*q && std::strchr("-+ #0", *q)) {
+            spec += *q++;
+        }
+        for (int part = 0; part < 2; ++part) {
+            if (part == 1) {
+                if (*q != '.') {
+                    break;
+                }
+                spec += *q++;
+            }
+            if (*q == '*') {
+                uint8_t tag = 0;
+                uint64_t bits = 0;
+                std::string text;
+                missing = missing || !next(tag, bits, text);
+                stars.push_back(static_cast<int>(as_integer(tag, bits)));
+                spec += *q++;
+            }
+            while (*q >= '0' && *q <= '9') {
+                spec += *q++;
+            }
+        }
+        while (*q && std::strchr("hlLqjzt", *q)) {
+            ++q;
+        }
+        char conversion = *q;
+        if (!conversion) {
+            break;
+        }
+        p = q + 1;
+
+        uint8_t tag = 0;
+        uint64_t bits = 0;
+        std::string text;
+        if (missing || !next(tag, bits, text)) {
+            message += record.truncated ? "…" : "<?>";
+            continue;
+        }
+
+        int a = stars.size() > 0 ? stars[0] : 0;
+        int b = stars.size() > 1 ? stars[1] : 0;
+        auto print = [&](auto value) {
+            switch (stars.size()) {
+            case 0:
+                std::snprintf(buffer, sizeof(buffer), spec.c_str(), value);
+                break;
+            case 1:
+                std::snprintf(buffer, sizeof(buffer), spec.c_str(), a, value);
+                break;
+            default:
+                std::snprintf(buffer, sizeof(buffer), spec.c_str(), a, b, value);
+                break;
+            }
+            message += buffer;
+        };
+
+        if (std::strchr("diouxX", conversion)) {
+            spec += "ll";
+            spec += conversion;
+            if (tag == 's') {
+                message += "<?>";
+            } else if (std::strchr("di", conversion)) {
+                print(as_integer(tag, bits));
+            } else {
+                print(static_cast<unsigned long long>(as_integer(tag, bits)));
+            }
+        } else if (std::strchr("eEfFgGaA", conversion)) {
+            spec += conversion;
+            double value = 0.0;
+            if (tag == 'd') {
+                std::memcpy(&value, &bits, sizeof(value));
+            } else if (tag == 'i') {
+                value = static_cast<double>(static_cast<int64_t>(bits));
+            } else if (tag == 'u') {
+                value = static_cast<double>(bits);
+            }
+            print(value);
+        } else if (conversion == 's') {
+            spec += 's';
+            if (tag == 's') {
+                print(text.c_str());
+            } else {
+                message += "<?>";
+            }
+        } else if (conversion == 'c') {
+            spec += 'c';
+            print(static_cast<int>(as_integer(tag, bits)));
+        } else if (conversion == 'p') {
+            spec += 'p';
+            print(reinterpret_cast<const void*>(static_cast<uintptr_t>(bits)));
+        } else {
+            message += "<?>";
+        }
+    }
+
+    if (record.truncated) {
+        message += " [参数过长已截断]";
+    }
+    return message;
+}
+
+void Logger::writeRecord(const LogRecord& record) {
+    // 普通信息写标准输出，警告和错误写标准错误（与原先 std::cout / std::cerr 的分工一致）
+    std::ostream& out = record.level >= LogLevel::Warning ? std::cerr : std::cout;
+
+    char prefix[128];
+    std::snprintf(prefix, sizeof(prefix), "[%9.3fms] [%s] [T%u]",
+                  record.timestamp_us / 1000.0, levelName(record.level), record.thread_index);
+    out << prefix;
+    if (record.building_id[0] != '\0') {
+        out << " [" << record.building_id << "]";
+    }
+    out << " [" << record.stage << "] " << formatMessage(record) << '\n';
+}
+
+size_t Logger::drain() {
+    std::lock_guard<std::mutex> drain_lock(drain_mutex_);
+
+    std::vector<Ring*> rings;
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings.reserve(rings_.size());
+        for (const auto& ring : rings_) {
+            rings.push_back(ring.get());
+        }
+    }
+
+    size_t count = 0;
+    for (Ring* ring : rings) {
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        for (; tail < head; ++tail) {
+            writeRecord(ring->records[tail % kRingCapacity]);
+            ++count;
+        }
+        ring->tail.store(tail, std::memory_order_release);
+
+        uint64_t dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            std::cerr << "[logger] [T" << ring->thread_index.load(std::memory_order_relaxed) << "] 缓冲区已满，丢弃 "
+                      << dropped << " 条日志\n";
+        }
+    }
+
+    if (count > 0) {
+        std::cout.flush();
+        std::cerr.flush();
+    }
+    return count;
+}
+
+void Logger::run() {
+    while (running_.load(std::memory_order_acquire)) {
+        if (drain() == 0) {
+            // 空闲时短暂休眠；生产者不做任何通知，避免热路径上的系统调用
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_.wait_for(lock, std::chrono::milliseconds(5));
+        }
+    }
+    drain();
+}
+
+void Logger::flush() {
+    drain();
+}
+
+void Logger::shutdown() {
+    if (running_.exchange(false)) {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+        }
+        wake_.notify_all();
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+    drain();
+}
+
+}
@@ -0,0 +1,295 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// 日志级别（数值用于编译期裁剪）
+#define ROOF_LOG_LEVEL_DEBUG 0
+#define ROOF_LOG_LEVEL_INFO 1
+#define ROOF_LOG_LEVEL_WARNING 2
+#define ROOF_LOG_LEVEL_ERROR 3
+#define ROOF_LOG_LEVEL_OFF 4
+
+// 低于该级别的日志调用在编译期即被移除，可通过预处理器定义覆盖
+#ifndef ROOF_OUTLINE_LOG_LEVEL
+#define ROOF_OUTLINE_LOG_LEVEL ROOF_LOG_LEVEL_INFO
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ROOF_LOG_PRINTF_FORMAT(fmt_index, args_index) __attribute__((format(printf, fmt_index, args_index)))
+#else
+#define ROOF_LOG_PRINTF_FORMAT(fmt_index, args_index)
+#endif
+
+namespace RoofOutline {
+
+enum class LogLevel : uint8_t {
+    Debug = ROOF_LOG_LEVEL_DEBUG,
+    Info = ROOF_LOG_LEVEL_INFO,
+    Warning = ROOF_LOG_LEVEL_WARNING,
+    Error = ROOF_LOG_LEVEL_ERROR
+};
+
+/**
+ * 一条日志记录（定长）
+ * 生产者只写入格式字符串指针和未格式化的参数，格式化由后台线程完成
+ */
+struct LogRecord {
+    int64_t timestamp_us;       // 相对日志系统启动的微秒数
+    LogLevel level;
+    uint32_t thread_index;      // 产生日志的线程序号
+    const char* stage;          // 处理阶段（必须是字符串字面量）
+    const char* format;         // 格式字符串（必须是字符串字面量）
+    uint32_t arg_bytes;         // args 中已使用的字节数
+    bool truncated;             // 参数区放不下，后续参数已丢弃
+    char building_id[48];
+    uint8_t args[240];          // 参数：每个为 1 字节类型标记 + 值；字符串为 2 字节长度 + 内容（参数可能是临时对象，须复制）
+};
+
+/**
+ * 把日志参数按类型标记依次写入 LogRecord::args（热路径上只有定长的内存复制）
+ */
+class LogArgWriter {
+public:
+    explicit LogArgWriter(LogRecord& record)
+        : record_(record)
+    {
+        record_.arg_bytes = 0;
+        record_.truncated = false;
+    }
+
+    template <typename T>
+    void put(T value) {
+        if constexpr (std::is_same<T, const char*>::value || std::is_same<T, char*>::value) {
+            putString(value);
+        } else if constexpr (std::is_enum<T>::value) {
+            put(static_cast<typename std::underlying_type<T>::type>(value));
+        } else if constexpr (std::is_floating_point<T>::value) {
+            putScalar('d', static_cast<double>(value));
+        } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+            putScalar('i', static_cast<int64_t>(value));
+        } else if constexpr (std::is_integral<T>::value) {
+            putScalar('u', static_cast<uint64_t>(value));
+        } else {
+            static_assert(std::is_pointer<T>::value, "unsupported log argument type");
+            putScalar('p', reinterpret_cast<uintptr_t>(value));
+        }
+    }
+
+private:
+    template <typename T>
+    void putScalar(uint8_t tag, T value) {
+        if (record_.truncated || record_.arg_bytes + 1 + sizeof(T) > sizeof(record_.args)) {
+            record_.truncated = true;
+            return;
+        }
+        record_.args[record_.arg_bytes] = tag;
+        std::memcpy(record_.args + record_.arg_bytes + 1, &value, sizeof(T));
+        record_.arg_bytes += 1 + sizeof(T);
+    }
+
+    void putString(const char* value) {
+        if (record_.truncated || record_.arg_bytes + 3 > sizeof(record_.args)) {
+            record_.truncated = true;
+            return;
+        }
+        if (!value) {
+            value = "(null)";
+        }
+        size_t room = sizeof(record_.args) - record_.arg_bytes - 3;
+        size_t length = strnlen(value, room + 1);
+        if (length > room) {
+            length = room;
+            record_.truncated = true;
+        }
+        uint16_t stored = static_cast<uint16_t>(length);
+        record_.args[record_.arg_bytes] = 's';
+        std::memcpy(record_.args + record_.arg_bytes + 1, &stored, sizeof(stored));
+        std::memcpy(record_.args + record_.arg_bytes + 3, value, length);
+        record_.arg_bytes += 3 + static_cast<uint32_t>(length);
+    }
+
+    LogRecord& record_;
+};
+
+/**
+ * 结构化日志模块
+ * 每个线程写入自己的无锁单生产者环形缓冲区，由后台线程统一取出、格式化并输出。
+ * 热路径上只复制格式字符串指针与原始参数并做一次原子发布，不做格式化，也不会在输出流的锁上互相阻塞；
+ * 线程退出后其缓冲区交给新线程复用
+ */
+class Logger {
+public:
+    static Logger& instance();
+
+    ~Logger();
+
+    /**
+     * 写入一条日志（printf 风格，由后台线程格式化）；缓冲区满时丢弃并计数，从不阻塞
+     * @param level 日志级别
+     * @param stage 处理阶段（字符串字面量）
+     * @param format 格式字符串（字符串字面量）
+     * @param args 参数（整数、浮点数、C 字符串或指针；字符串在调用时复制）
+     */
+    template <typename... Args>
+    void log(LogLevel level, const char* stage, const char* format, const Args&... args) {
+        Ring* ring = threadRing();
+        LogRecord* record = reserve(ring, level, stage, format);
+        if (!record) {
+            return;
+        }
+        LogArgWriter writer(*record);
+        (writer.put(args), ...);
+        ring->head.store(ring->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+     * 仅用于编译期检查格式字符串与参数是否匹配（日志宏在不求值的分支中调用）
+     */
+    static void checkFormat(const char* format, ...) ROOF_LOG_PRINTF_FORMAT(1, 2);
+
+    /**
+     * 设置当前线程后续日志携带的建筑标识
+     */
+    static void setBuildingId(const std::string& building_id);
+
+    /**
+     * 获取当前线程的建筑标识
+     */
+    static const std::string& buildingId();
+
+    /**
+     * 立即输出所有已缓冲的日志（阻塞直到取空）
+     */
+    void flush();
+
+    /**
+     * 停止后台线程并输出剩余日志
+     */
+    void shutdown();
+
+private:
+    static const size_t kRingCapacity = 1024;
+
+    struct Ring {
+        LogRecord records[kRingCapacity];
+        std::atomic<uint64_t> head{0};      // 生产者写位置
+        std::atomic<uint64_t> tail{0};      // 消费者读位置
+        std::atomic<uint64_t> dropped{0};   // 因缓冲区满而丢弃的记录数
+        std::atomic<uint32_t> thread_index{0};
+        std::atomic<bool> in_use{true};     // 所属线程仍在运行；退出后可交给新线程继续写入
+    };
+
+    /**
+     * 线程退出时归还其环形缓冲区
+     */
+    struct RingLease {
+        Ring* ring = nullptr;
+        ~RingLease();
+    };
+
+    Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /**
+     * 获取当前线程的环形缓冲区；首次调用时优先复用已退出线程留下的缓冲区
+     */
+    Ring* threadRing();
+
+    /**
+     * 在环形缓冲区中预留一条记录并填写记录头；缓冲区满时计数并返回 nullptr
+     */
+    LogRecord* reserve(Ring* ring, LogLevel level, const char* stage, const char* format);
+
+    /**
+     * 按格式字符串与记录中的参数格式化日志正文
+     */
+    static std::string formatMessage(const LogRecord& record);
+
+    /**
+     * 取出所有环形缓冲区中的记录并输出，返回输出条数
+     */
+    size_t drain();
+
+    /**
+     * 后台线程主循环
+     */
+    void run();
+
+    static void writeRecord(const LogRecord& record);
+
+    std::vector<std::unique_ptr<Ring>> rings_;
+    std::mutex rings_mutex_;     // 仅在注册新线程和遍历缓冲区列表时使用
+    std::mutex drain_mutex_;     // 保证同一时间只有一个消费者
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::atomic<bool> running_{false};
+    uint32_t next_thread_index_ = 0;
+    std::thread worker_;
+    int64_t start_time_us_ = 0;
+};
+
+inline void Logger::checkFormat(const char*, ...) {
+}
+
+/**
+ * 作用域内为当前线程设置建筑标识，离开作用域时恢复
+ */
+class LogContext {
+public:
+    explicit LogContext(const std::string& building_id)
+        : previous_(Logger::buildingId())
+    {
+        Logger::setBuildingId(building_id);
+    }
+
+    ~LogContext() {
+        Logger::setBuildingId(previous_);
+    }
+
+private:
+    std::string previous_;
+};
+
+}
+
+#if ROOF_OUTLINE_LOG_LEVEL <= ROOF_LOG_LEVEL_DEBUG
+#define ROOF_LOG_DEBUG(stage, ...) \
+    (false ? ::RoofOutline::Logger::checkFormat(__VA_ARGS__) \
+           : ::RoofOutline::Logger::instance().log(::RoofOutline::LogLevel::Debug, stage, __VA_ARGS__))
+#else
+#define ROOF_LOG_DEBUG(stage, ...) ((void)0)
+#endif
+
+#if ROOF_OUTLINE_LOG_LEVEL <= ROOF_LOG_LEVEL_INFO
+#define ROOF_LOG_INFO(stage, ...) \
+    (false ? ::RoofOutline::Logger::checkFormat(__VA_ARGS__) \
+           : ::RoofOutline::Logger::instance().log(::RoofOutline::LogLevel::Info, stage, __VA_ARGS__))
+#else
+#define ROOF_LOG_INFO(stage, ...) ((void)0)
+#endif
+
+#if ROOF_OUTLINE_LOG_LEVEL <= ROOF_LOG_LEVEL_WARNING
+#define ROOF_LOG_WARNING(stage, ...) \
+    (false ? ::RoofOutline::Logger::checkFormat(__VA_ARGS__) \
+           : ::RoofOutline::Logger::instance().log(::RoofOutline::LogLevel::Warning, stage, __VA_ARGS__))
+#else
+#define ROOF_LOG_WARNING(stage, ...) ((void)0)
+#endif
+
+#if ROOF_OUTLINE_LOG_LEVEL <= ROOF_LOG_LEVEL_ERROR
+#define ROOF_LOG_ERROR(stage, ...) \
+    (false ? ::RoofOutline::Logger::checkFormat(__VA_ARGS__) \
+           : ::RoofOutline::Logger::instance().log(::RoofOutline::LogLevel::Error, stage, __VA_ARGS__))
+#else
+#define ROOF_LOG_ERROR(stage, ...) ((void)0)
+#endif
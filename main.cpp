@@ -3,13 +3,286 @@
 #include "coordinate_transform.h"
 #include "svg_renderer.h"
 #include "roof_unfold.h"
-#include <iostream>
+#include "unfold_layout.h"
+#include "raster_renderer.h"
+#include "roof_statistics.h"
+#include "roof_offsets.h"
+#include "cost_model.h"
+#include "batch_scheduler.h"
+#include "shared_result_sink.h"
+#include "shared_result_benchmark.h"
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+#include <string>
 #include <vector>
 
 using namespace RoofOutline;
 
-int main()
+namespace {
+
+// 输出选项
+struct OutputOptions {
+	bool metrics_only = false;                  // 只输出统计数据，跳过所有渲染
+	SharedResultSink* shared_sink = nullptr;    // 非空时把结果发布到共享内存
+	bool shared_svg = false;                    // 共享内存结果中附带SVG
+	int shared_wait_ms = 0;                     // 退出前等待尚未连接的消费者的时间
+	std::vector<double> inset_distances = {0.5, 1.0};   // 内收线距离
+	std::vector<double> overhang_distances = {0.6};     // 挑檐距离
+};
+
+// 共享内存缓冲区满时等待消费者的最长时间
+const int kSharedPublishTimeoutMs = 1000;
+
+// 退出前等待已连接的消费者读完共享内存结果的最长时间
+const int kSharedDrainTimeoutMs = 5000;
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 解析逗号分隔的正数距离列表，如 "0.5,1.0"
+bool parseDistances(const std::string& text, std::vector<double>& distances)
+{
+	std::vector<double> parsed;
+	std::istringstream input(text);
+	std::string field;
+	while (std::getline(input, field, ',')) {
+		char* end = nullptr;
+		double value = std::strtod(field.c_str(), &end);
+		if (field.empty() || *end != '\0' || !(value > 0.0)) {
+			return false;
+		}
+		parsed.push_back(value);
+	}
+	if (parsed.empty()) {
+		return false;
+	}
+	distances.swap(parsed);
+	return true;
+}
+
+// 偏移轮廓：内收线复用已有的内部直骨架，外部直骨架只创建一次，供所有挑檐距离共用
+std::vector<OffsetOutline> computeOffsets(const Polygon_2& polygon, const SsPtr& skeleton, const OutputOptions& options)
+{
+	std::vector<OffsetOutline> offsets = RoofOffsets::interiorOffsets(skeleton, options.inset_distances);
+	if (options.overhang_distances.empty()) {
+		return offsets;
+	}
+	double max_overhang = *std::max_element(options.overhang_distances.begin(), options.overhang_distances.end());
+	SsPtr exterior_skeleton = Geometry::createExteriorSkeleton(polygon, max_overhang);
+	if (exterior_skeleton) {
+		auto overhangs = RoofOffsets::exteriorOffsets(exterior_skeleton, polygon, options.overhang_distances);
+		offsets.insert(offsets.end(), overhangs.begin(), overhangs.end());
+	}
+	return offsets;
+}
+
+// 批处理中单栋建筑的处理：直骨架、偏移轮廓、统计、展开排布、缩略图与共享内存输出，分别计时
+bool processBatchJob(const BatchJob& job, const OutputOptions& options, double roof_angle,
+	RoofMetrics& metrics, std::vector<OffsetOutline>& offsets, RepairReport& repair, StageTimes& actual)
+{
+	Polygon_2 polygon = job.polygon;
+	if (!Geometry::validateAndFixPolygon(polygon, repair)) {
+		return false;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	SsPtr skeleton = Geometry::createInteriorSkeleton(polygon);
+	if (!skeleton) {
+		actual.skeleton_ms = elapsedMs(start);
+		return false;
+	}
+	actual.skeleton_ms = elapsedMs(start);
+
+	start = std::chrono::steady_clock::now();
+	offsets = computeOffsets(polygon, skeleton, options);
+	actual.offset_ms = elapsedMs(start);
+
+	double min_x, max_x, min_y, max_y;
+	Geometry::calculateBoundingBox(polygon, min_x, max_x, min_y, max_y);
+	CoordinateTransform ridge_transform(min_x, max_x, min_y, max_y, 800);
+	const std::vector<std::pair<double, double>> gray_vertices;
+	metrics = RoofStatistics::compute(skeleton, roof_angle, ridge_transform, gray_vertices);
+	if (options.metrics_only) {
+		if (options.shared_sink) {
+			options.shared_sink->publish(job.building_id, skeleton, metrics, {}, std::string(), std::string(),
+				kSharedPublishTimeoutMs);
+		}
+		return true;
+	}
+
+	start = std::chrono::steady_clock::now();
+	double center_x, center_y, max_time;
+	if (!Geometry::findCenterVertex(skeleton, center_x, center_y, max_time)) {
+		center_x = 0.5 * (min_x + max_x);
+		center_y = 0.5 * (min_y + max_y);
+	}
+	RoofUnfold unfolder(skeleton, center_x, center_y, roof_angle, 0.0);
+	auto unfolded_faces = unfolder.computeUnfoldedFaces(ridge_transform, gray_vertices);
+	double layout_spacing = 0.03 * std::max(max_x - min_x, max_y - min_y);
+	if (!UnfoldLayout::arrange(skeleton, unfolded_faces, layout_spacing)) {
+		return false;
+	}
+	actual.unfold_ms = elapsedMs(start);
+
+	start = std::chrono::steady_clock::now();
+	const int thumbnail_width = 240;
+	RasterImage thumbnail;
+	CoordinateTransform ridge_thumb_transform(min_x, max_x, min_y, max_y, thumbnail_width);
+	if (!RasterRenderer::renderRidgeView(thumbnail, polygon, skeleton,
+		ridge_thumb_transform, ridge_transform, gray_vertices, offsets) ||
+		!RasterRenderer::writePNG(job.building_id + "_roof_ridges.png", thumbnail)) {
+		return false;
+	}
+
+	double unfold_min_x, unfold_max_x, unfold_min_y, unfold_max_y;
+	RoofUnfold::calculateUnfoldedBoundingBox(unfolded_faces,
+		unfold_min_x, unfold_max_x, unfold_min_y, unfold_max_y);
+	CoordinateTransform unfold_thumb_transform(unfold_min_x, unfold_max_x,
+		unfold_min_y, unfold_max_y, thumbnail_width);
+	if (!RasterRenderer::renderUnfoldedView(thumbnail, unfolded_faces, unfold_thumb_transform) ||
+		!RasterRenderer::writePNG(job.building_id + "_roof_unfolded.png", thumbnail)) {
+		return false;
+	}
+	actual.render_ms = elapsedMs(start);
+
+	// 发布到共享内存不计入渲染耗时：缓冲区满时的等待取决于消费者，会干扰耗时模型的校准
+	if (options.shared_sink) {
+		std::ostringstream ridge_svg, unfolded_svg;
+		if (options.shared_svg) {
+			CoordinateTransform unfold_transform(unfold_min_x, unfold_max_x, unfold_min_y, unfold_max_y, 1000);
+			SVGRenderer::renderRidgeView(ridge_svg, polygon, skeleton, ridge_transform, gray_vertices, offsets);
+			SVGRenderer::renderUnfoldedView(unfolded_svg, unfolded_faces, unfold_transform, roof_angle);
+		}
+		options.shared_sink->publish(job.building_id, skeleton, metrics, unfolded_faces,
+			ridge_svg.str(), unfolded_svg.str(), kSharedPublishTimeoutMs);
+	}
+	return true;
+}
+
+// 批处理：用以往的耗时记录校准耗时模型，按预测耗时从长到短调度，并追加本次的耗时记录
+int runBatch(const std::string& footprint_file, int worker_count, const OutputOptions& options)
 {
+	struct LogFlusher {
+		~LogFlusher() { Logger::instance().flush(); }
+	} log_flusher;
+
+	std::vector<BatchJob> jobs;
+	if (!BatchScheduler::loadFootprints(footprint_file, jobs)) {
+		return 1;
+	}
+
+	const std::string trace_file = "roof_trace.csv";
+	CostModel model;
+	std::vector<TraceRecord> history;
+	if (CostModel::loadTrace(trace_file, history)) {
+		model.calibrate(history);
+	}
+
+	double roof_angle = 30.0;
+	std::vector<RoofMetrics> metrics(jobs.size());
+	std::vector<std::vector<OffsetOutline>> offsets(jobs.size());
+	std::vector<RepairReport> repairs(jobs.size());
+	BatchScheduler scheduler(model, worker_count);
+	auto reports = scheduler.run(jobs, [&](size_t index, const BatchJob& job, StageTimes& actual) {
+		return processBatchJob(job, options, roof_angle, metrics[index], offsets[index], repairs[index], actual);
+	});
+
+	RoofStatisticsTable statistics;
+	std::vector<TraceRecord> trace;
+	for (size_t i = 0; i < jobs.size(); ++i) {
+		reports[i].repair = repairs[i];
+		if (!reports[i].success) {
+			continue;
+		}
+		statistics.add(jobs[i].building_id, metrics[i], offsets[i]);
+		if (!options.metrics_only) {
+			trace.push_back({reports[i].building_id, reports[i].features, reports[i].actual});
+		}
+	}
+
+	if (!statistics.writeCSV("roof_statistics.csv") ||
+		!statistics.writeFaceCSV("roof_face_statistics.csv") ||
+		!statistics.writeOffsetCSV("roof_offsets.csv") ||
+		!statistics.writeBinary("roof_statistics.bin") ||
+		!BatchScheduler::writeReport("roof_schedule_report.csv", reports) ||
+		!CostModel::appendTrace(trace_file, trace)) {
+		return 1;
+	}
+
+	ROOF_LOG_INFO("main", "✓ 批处理完成：%zu / %zu 个建筑成功", statistics.size(), jobs.size());
+	return statistics.size() == jobs.size() ? 0 : 1;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	// --metrics-only：只输出统计数据，跳过所有渲染
+	// --batch <文件>：批量处理轮廓列表文件；--workers <数量>：批处理线程数
+	// --shared-output <名称>：把结果发布到共享内存环形缓冲区；--shared-svg：共享内存结果附带SVG
+	// --shared-wait <毫秒>：退出前等待消费者连接并读完结果（默认只等待已连接的消费者）
+	// --benchmark-shared <次数>：对比共享内存与文件输出的吞吐量
+	// --inset-distances <距离,...>：内收线距离（默认 0.5,1.0）；--overhang-distances <距离,...>：挑檐距离（默认 0.6）
+	OutputOptions options;
+	std::string batch_file;
+	std::string shared_name;
+	int worker_count = 0;
+	int benchmark_iterations = 0;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--metrics-only") {
+			options.metrics_only = true;
+		} else if (arg == "--batch" && i + 1 < argc) {
+			batch_file = argv[++i];
+		} else if (arg == "--workers" && i + 1 < argc) {
+			worker_count = std::atoi(argv[++i]);
+		} else if (arg == "--shared-output" && i + 1 < argc) {
+			shared_name = argv[++i];
+		} else if (arg == "--shared-svg") {
+			options.shared_svg = true;
+		} else if (arg == "--shared-wait" && i + 1 < argc) {
+			options.shared_wait_ms = std::max(0, std::atoi(argv[++i]));
+		} else if (arg == "--benchmark-shared" && i + 1 < argc) {
+			benchmark_iterations = std::atoi(argv[++i]);
+		} else if ((arg == "--inset-distances" || arg == "--overhang-distances") && i + 1 < argc) {
+			std::vector<double>& distances = arg == "--inset-distances" ? options.inset_distances : options.overhang_distances;
+			if (!parseDistances(argv[++i], distances)) {
+				ROOF_LOG_ERROR("main", "%s 需要逗号分隔的正数距离列表: %s", arg.c_str(), argv[i]);
+				return 1;
+			}
+		}
+	}
+
+	// 退出时共享内存名称随之删除：先等待已连接的消费者读完已发布的结果
+	SharedResultSink shared_sink;
+	struct SharedSinkDrainer {
+		SharedResultSink& sink;
+		int wait_ms;
+		~SharedSinkDrainer() { sink.drain(kSharedDrainTimeoutMs, wait_ms); }
+	} shared_sink_drainer{shared_sink, options.shared_wait_ms};
+	if (!shared_name.empty()) {
+		if (!shared_sink.open(shared_name, 64u << 20)) {
+			return 1;
+		}
+		options.shared_sink = &shared_sink;
+	}
+
+	if (!batch_file.empty()) {
+		return runBatch(batch_file, worker_count, options);
+	}
+
+	// 日志携带建筑标识；退出前输出所有缓冲的日志
+	const std::string building_id = "L-shape";
+	LogContext log_context(building_id);
+	struct LogFlusher {
+		~LogFlusher() { Logger::instance().flush(); }
+	} log_flusher;
+
 	// 创建多边形 
 	Polygon_2 polygon;
 	polygon.push_back(Point(0, 0));
@@ -20,7 +293,8 @@ int main()
 	polygon.push_back(Point(-5, 0));
 
 	//  验证并修正多边形
-	if (!Geometry::validateAndFixPolygon(polygon)) {
+	RepairReport repair;
+	if (!Geometry::validateAndFixPolygon(polygon, repair)) {
 		return 1;
 	}
 
@@ -44,9 +318,33 @@ int main()
 		{66.6667, 66.3333}
 	};
 
+	// 偏移轮廓（内收线与挑檐）
+	std::vector<OffsetOutline> offsets = computeOffsets(polygon, skeleton, options);
+
+	// 统计屋顶数值指标（不依赖渲染）
+	double roof_angle = 30.0;
+	RoofMetrics metrics = RoofStatistics::compute(skeleton, roof_angle, ridge_transform, gray_vertices);
+	RoofStatisticsTable statistics;
+	statistics.add(building_id, metrics, offsets);
+	if (!statistics.writeCSV("roof_statistics.csv") ||
+		!statistics.writeFaceCSV("roof_face_statistics.csv") ||
+		!statistics.writeOffsetCSV("roof_offsets.csv") ||
+		!statistics.writeBinary("roof_statistics.bin")) {
+		return 1;
+	}
+
+	if (options.metrics_only) {
+		if (options.shared_sink) {
+			options.shared_sink->publish(building_id, skeleton, metrics, {}, std::string(), std::string(),
+				kSharedPublishTimeoutMs);
+		}
+		ROOF_LOG_INFO("main", "✓ 统计文件生成完成！");
+		return 0;
+	}
+
 	// 渲染屋脊线俯视图
 	if (!SVGRenderer::renderRidgeView("roof_ridges.svg", polygon, skeleton, 
-		ridge_transform, gray_vertices)) {
+		ridge_transform, gray_vertices, offsets)) {
 		return 1;
 	}
 
@@ -56,26 +354,69 @@ int main()
 		// 如果没找到，使用几何中心
 		center_x = 5.0;
 		center_y = -2.5;
-		std::cout << "使用默认几何中心: (" << center_x << ", " << center_y << ")" << std::endl;
+		ROOF_LOG_INFO("main", "使用默认几何中心: (%g, %g)", center_x, center_y);
 	}
 
 	//  计算屋顶展开
-	double roof_angle = 30.0; 
-	RoofUnfold unfolder(skeleton, center_x, center_y, roof_angle, 0.15);
+	RoofUnfold unfolder(skeleton, center_x, center_y, roof_angle, 0.0);
 	auto unfolded_faces = unfolder.computeUnfoldedFaces(ridge_transform, gray_vertices);
 
+	// 排布展开面：互不重叠，间距为建筑尺寸的 3%
+	double layout_spacing = 0.03 * std::max(max_x - min_x, max_y - min_y);
+	if (!UnfoldLayout::arrange(skeleton, unfolded_faces, layout_spacing)) {
+		return 1;
+	}
+
 	double unfold_min_x, unfold_max_x, unfold_min_y, unfold_max_y;
 	RoofUnfold::calculateUnfoldedBoundingBox(unfolded_faces, 
 		unfold_min_x, unfold_max_x, unfold_min_y, unfold_max_y);
 	CoordinateTransform unfold_transform(unfold_min_x, unfold_max_x, 
 		unfold_min_y, unfold_max_y, 1000);
 
+	// 吞吐量对比：在内存中渲染两份SVG，分别经文件和共享内存重复交付
+	if (benchmark_iterations > 0) {
+		std::ostringstream ridge_svg, unfolded_svg;
+		SVGRenderer::renderRidgeView(ridge_svg, polygon, skeleton, ridge_transform, gray_vertices, offsets);
+		SVGRenderer::renderUnfoldedView(unfolded_svg, unfolded_faces, unfold_transform, roof_angle);
+		return SharedResultBenchmark::run(building_id, skeleton, metrics, unfolded_faces,
+			ridge_svg.str(), unfolded_svg.str(), benchmark_iterations) ? 0 : 1;
+	}
+
 	// 渲染展开图
 	if (!SVGRenderer::renderUnfoldedView("roof_unfolded.svg", unfolded_faces, 
 		unfold_transform, roof_angle)) {
 		return 1;
 	}
 
-	std::cout << "\n✓ 所有文件生成完成！" << std::endl;
+	// 生成PNG缩略图
+	const int thumbnail_width = 240;
+	RasterImage thumbnail;
+
+	CoordinateTransform ridge_thumb_transform(min_x, max_x, min_y, max_y, thumbnail_width);
+	if (!RasterRenderer::renderRidgeView(thumbnail, polygon, skeleton,
+		ridge_thumb_transform, ridge_transform, gray_vertices, offsets) ||
+		!RasterRenderer::writePNG("roof_ridges.png", thumbnail)) {
+		return 1;
+	}
+
+	CoordinateTransform unfold_thumb_transform(unfold_min_x, unfold_max_x,
+		unfold_min_y, unfold_max_y, thumbnail_width);
+	if (!RasterRenderer::renderUnfoldedView(thumbnail, unfolded_faces, unfold_thumb_transform) ||
+		!RasterRenderer::writePNG("roof_unfolded.png", thumbnail)) {
+		return 1;
+	}
+
+	// 发布到共享内存
+	if (options.shared_sink) {
+		std::ostringstream ridge_svg, unfolded_svg;
+		if (options.shared_svg) {
+			SVGRenderer::renderRidgeView(ridge_svg, polygon, skeleton, ridge_transform, gray_vertices, offsets);
+			SVGRenderer::renderUnfoldedView(unfolded_svg, unfolded_faces, unfold_transform, roof_angle);
+		}
+		options.shared_sink->publish(building_id, skeleton, metrics, unfolded_faces,
+			ridge_svg.str(), unfolded_svg.str(), kSharedPublishTimeoutMs);
+	}
+
+	ROOF_LOG_INFO("main", "✓ 所有文件生成完成！");
 	return 0;
 }
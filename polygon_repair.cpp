@@ -0,0 +1,599 @@
+#include "polygon_repair.h"
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <set>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace RoofOutline {
+
+namespace {
+
+/**
+ * 边上的拆分点：参数 t（0~1）与点编号
+ */
+struct SplitPoint {
+    double t;
+    int id;
+};
+
+bool nearPoint(const Point& a, const Point& b, double epsilon) {
+    return std::abs(a.x() - b.x()) <= epsilon && std::abs(a.y() - b.y()) <= epsilon;
+}
+
+/**
+ * b 处的两条边共线且方向相反（轮廓在 b 处折返）
+ */
+bool isSpike(const Point& a, const Point& b, const Point& c) {
+    double ux = b.x() - a.x(), uy = b.y() - a.y();
+    double vx = c.x() - b.x(), vy = c.y() - b.y();
+    double cross = ux * vy - uy * vx;
+    double dot = ux * vx + uy * vy;
+    double scale = std::sqrt((ux * ux + uy * uy) * (vx * vx + vy * vy));
+    return dot < 0 && std::abs(cross) <= 1e-9 * scale;
+}
+
+/**
+ * 坐标容差：与坐标量级成比例
+ */
+double ringTolerance(const std::vector<Point>& ring) {
+    double extent = 0.0;
+    for (const auto& p : ring) {
+        extent = std::max(extent, std::max(std::abs(p.x()), std::abs(p.y())));
+    }
+    return 1e-9 * std::max(1.0, extent);
+}
+
+double signedArea(const std::vector<Point>& ring) {
+    double twice_area = 0.0;
+    for (size_t i = 0; i < ring.size(); ++i) {
+        const Point& p = ring[i];
+        const Point& q = ring[(i + 1) % ring.size()];
+        twice_area += p.x() * q.y() - q.x() * p.y();
+    }
+    return twice_area * 0.5;
+}
+
+/**
+ * 删除重复顶点和尖刺（线性时间；删除后新出现的重复和尖刺，包括首尾相接处，一并处理）
+ */
+void removeDegeneracies(std::vector<Point>& ring, double epsilon, RepairReport& report) {
+    std::deque<Point> result;
+    for (const auto& p : ring) {
+        if (!result.empty() && nearPoint(result.back(), p, epsilon)) {
+            report.duplicate_vertices++;
+            continue;
+        }
+
+        bool duplicate = false;
+        while (result.size() >= 2 && isSpike(result[result.size() - 2], result.back(), p)) {
+            result.pop_back();
+            report.spikes++;
+            if (nearPoint(result.back(), p, epsilon)) {
+                report.duplicate_vertices++;
+                duplicate = true;
+                break;
+            }
+        }
+        if (!duplicate) {
+            result.push_back(p);
+        }
+    }
+
+    bool changed = true;
+    while (changed && result.size() >= 3) {
+        changed = true;
+        size_t n = result.size();
+        if (nearPoint(result[n - 1], result[0], epsilon)) {
+            result.pop_back();
+            report.duplicate_vertices++;
+        } else if (isSpike(result[n - 2], result[n - 1], result[0])) {
+            result.pop_back();
+            report.spikes++;
+        } else if (isSpike(result[n - 1], result[0], result[1])) {
+            result.pop_front();
+            report.spikes++;
+        } else {
+            changed = false;
+        }
+    }
+
+    ring.assign(result.begin(), result.end());
+}
+
+/**
+ * 自交点查找器
+ * Bentley-Ottmann 扫描：扫描线上的边按当前 x 处的 y 排序，只对新成为相邻的边对以及经过同一事件点的边求交，
+ * 复杂度 O((n + k) log n)。交点和边与顶点的接触都记为边上的拆分点
+ */
+class IntersectionFinder {
+public:
+    IntersectionFinder(const std::vector<Point>& ring, double epsilon)
+        : ring_(ring)
+        , points_(ring)
+        , vertex_ids_(ring.size())
+        , splits_(ring.size())
+        , epsilon_(epsilon)
+    {
+    }
+
+    int run() {
+        mergeCoincidentVertices();
+        sweep();
+        return intersections_;
+    }
+
+    /**
+     * 按边顺序插入拆分点后的闭合点编号序列
+     */
+    std::vector<int> walk() {
+        // 多条边交于同一点时，各边对分别求出的交点需要归并为同一编号
+        std::vector<int> canonical;
+        mergeCoincidentPoints(canonical);
+
+        std::vector<int> sequence;
+        sequence.reserve(ring_.size());
+        for (size_t i = 0; i < ring_.size(); ++i) {
+            auto push = [&sequence, &canonical](int id) {
+                id = canonical[id];
+                if (sequence.empty() || sequence.back() != id) {
+                    sequence.push_back(id);
+                }
+            };
+            push(vertex_ids_[i]);
+            auto& splits = splits_[i];
+            std::sort(splits.begin(), splits.end(), [](const SplitPoint& a, const SplitPoint& b) { return a.t < b.t; });
+            for (const auto& split : splits) {
+                push(split.id);
+            }
+        }
+        while (sequence.size() > 1 && sequence.back() == sequence.front()) {
+            sequence.pop_back();
+        }
+        return sequence;
+    }
+
+    const std::vector<Point>& points() const { return points_; }
+
+    /**
+     * 产生了拆分点的不相邻边对 (e, f)，e < f
+     */
+    const std::vector<std::pair<int, int>>& pairs() const { return pairs_; }
+
+private:
+    /**
+     * 坐标重合（容差内）的点编号归并到同一代表编号，返回被归并的点数
+     */
+    int mergeCoincidentPoints(std::vector<int>& canonical) const {
+        size_t count = points_.size();
+        canonical.resize(count);
+        std::vector<int> order(count);
+        for (size_t i = 0; i < count; ++i) {
+            order[i] = static_cast<int>(i);
+            canonical[i] = static_cast<int>(i);
+        }
+        std::sort(order.begin(), order.end(), [this](int a, int b) {
+            return points_[a].x() < points_[b].x() || (points_[a].x() == points_[b].x() && points_[a].y() < points_[b].y());
+        });
+
+        int merged = 0;
+        for (size_t k = 0; k < count; ++k) {
+            int current = order[k];
+            if (canonical[current] != current) {
+                continue;
+            }
+            for (size_t m = k + 1; m < count && points_[order[m]].x() - points_[current].x() <= epsilon_; ++m) {
+                int other = order[m];
+                if (canonical[other] == other && nearPoint(points_[current], points_[other], epsilon_)) {
+                    canonical[other] = current;
+                    merged++;
+                }
+            }
+        }
+        return merged;
+    }
+
+    /**
+     * 不相邻但坐标重合的顶点视为同一点（轮廓在该点与自身相接）
+     */
+    void mergeCoincidentVertices() {
+        std::vector<int> canonical;
+        intersections_ += mergeCoincidentPoints(canonical);
+        vertex_ids_ = canonical;
+    }
+
+    bool adjacent(int e, int f) const {
+        int n = static_cast<int>(ring_.size());
+        return (e + 1) % n == f || (f + 1) % n == e;
+    }
+
+    /**
+     * 点到边的距离是否在容差内
+     */
+    bool nearEdge(const Point& point, int e) const {
+        int n = static_cast<int>(ring_.size());
+        const Point& p = ring_[e];
+        const Point& q = ring_[(e + 1) % n];
+        double dx = q.x() - p.x(), dy = q.y() - p.y();
+        double length_squared = dx * dx + dy * dy;
+        double t = length_squared > 0 ? ((point.x() - p.x()) * dx + (point.y() - p.y()) * dy) / length_squared : 0.0;
+        t = std::max(0.0, std::min(1.0, t));
+        return std::hypot(point.x() - p.x() - t * dx, point.y() - p.y() - t * dy) <= 2 * epsilon_;
+    }
+
+    /**
+     * 对一对不相邻的边求交（每对最多一次），并记录产生了拆分点的边对
+     */
+    void test(int e, int f) {
+        if (e == f || adjacent(e, f)) {
+            return;
+        }
+        uint64_t key = (static_cast<uint64_t>(std::min(e, f)) << 32) | static_cast<uint64_t>(std::max(e, f));
+        if (!tested_.insert(key).second) {
+            return;
+        }
+        int before = intersections_;
+        intersect(e, f);
+        if (intersections_ > before) {
+            pairs_.push_back({std::min(e, f), std::max(e, f)});
+        }
+    }
+
+    /**
+     * Bentley-Ottmann 扫描。事件为边的左右端点和两条边的交叉点：
+     * 插入边时与上下相邻的边求交，删除边时让其上下两条边求交，交叉点处交换两条边的次序后再与新邻居求交。
+     * 多条边经过同一事件点（交于一点、T 形相接、共线重叠）时它们在扫描线上连成一片，逐一检查。
+     * 为避免竖直边（正交轮廓中很常见），排序用的坐标做一个微小的错切；求交仍用原坐标
+     */
+    void sweep() {
+        int n = static_cast<int>(ring_.size());
+        const double shear = 1e-3 / 3.14159265358979323846;
+
+        std::vector<double> xs(n), ys(n);
+        for (int i = 0; i < n; ++i) {
+            xs[i] = ring_[i].x() + shear * ring_[i].y();
+            ys[i] = ring_[i].y();
+        }
+
+        enum EventKind { Remove = 0, Cross = 1, Insert = 2 };
+        struct SweepEvent {
+            double x;
+            double y;
+            int kind;
+            int edge;       // 插入、删除的边；交叉时为下方的边
+            int other;      // 交叉时为上方的边
+        };
+        // 按 x、y 排序；同一点上先删除，再交换，最后插入
+        auto later = [](const SweepEvent& a, const SweepEvent& b) {
+            if (a.x != b.x) return a.x > b.x;
+            if (a.y != b.y) return a.y > b.y;
+            return a.kind > b.kind;
+        };
+        std::priority_queue<SweepEvent, std::vector<SweepEvent>, decltype(later)> events(later);
+
+        std::vector<int> left(n), right(n);
+        for (int e = 0; e < n; ++e) {
+            int a = e, b = (e + 1) % n;
+            bool a_first = xs[a] < xs[b] || (xs[a] == xs[b] && ys[a] < ys[b]);
+            left[e] = a_first ? a : b;
+            right[e] = a_first ? b : a;
+            events.push({xs[left[e]], ys[left[e]], Insert, e, -1});
+            events.push({xs[right[e]], ys[right[e]], Remove, e, -1});
+        }
+
+        double sweep_x = std::numeric_limits<double>::lowest();
+        auto y_at = [&](int e, double x) {
+            double x0 = xs[left[e]], x1 = xs[right[e]];
+            if (x1 <= x0) {
+                return ys[left[e]];
+            }
+            double t = std::max(0.0, std::min(1.0, (x - x0) / (x1 - x0)));
+            return ys[left[e]] + t * (ys[right[e]] - ys[left[e]]);
+        };
+        auto slope = [&](int e) {
+            double dx = xs[right[e]] - xs[left[e]];
+            double dy = ys[right[e]] - ys[left[e]];
+            return dx > 0 ? dy / dx : (dy >= 0 ? 1e300 : -1e300);
+        };
+
+        // 边在集合中的位置只在插入时由比较函数决定；交叉点处直接交换两个节点中的边编号，不再调用比较函数
+        struct Slot {
+            mutable int edge;
+        };
+        auto below = [&](const Slot& a, const Slot& b) {
+            double ya = y_at(a.edge, sweep_x), yb = y_at(b.edge, sweep_x);
+            if (ya != yb) return ya < yb;
+            double sa = slope(a.edge), sb = slope(b.edge);
+            if (sa != sb) return sa < sb;
+            return a.edge < b.edge;
+        };
+        typedef std::set<Slot, std::function<bool(const Slot&, const Slot&)>> Status;
+        Status status(below);
+        std::vector<Status::iterator> handles(n, status.end());
+        std::unordered_set<uint64_t> crossed;
+
+        // lower 紧挨在 upper 之下：求交，若两者在前方交叉（交点不在端点上）则安排交换事件
+        auto neighbours = [&](int lower, int upper) {
+            test(lower, upper);
+            uint64_t key = (static_cast<uint64_t>(std::min(lower, upper)) << 32) |
+                           static_cast<uint64_t>(std::max(lower, upper));
+            if (crossed.count(key)) {
+                return;
+            }
+            double end = std::min(xs[right[lower]], xs[right[upper]]);
+            if (end <= sweep_x) {
+                return;
+            }
+            double d0 = std::max(0.0, y_at(upper, sweep_x) - y_at(lower, sweep_x));
+            double d1 = y_at(upper, end) - y_at(lower, end);
+            if (d1 >= 0) {
+                return;
+            }
+            double x = sweep_x + (end - sweep_x) * d0 / (d0 - d1);
+            events.push({x, y_at(lower, x), Cross, lower, upper});
+        };
+        // 与经过事件点的所有边求交
+        auto through = [&](Status::iterator it, const Point& point) {
+            for (auto down = it; down != status.begin();) {
+                --down;
+                if (!nearEdge(point, down->edge)) {
+                    break;
+                }
+                test(it->edge, down->edge);
+            }
+            for (auto up = std::next(it); up != status.end() && nearEdge(point, up->edge); ++up) {
+                test(it->edge, up->edge);
+            }
+        };
+
+        while (!events.empty()) {
+            SweepEvent event = events.top();
+            events.pop();
+            // 交叉点由浮点计算得到，可能略早于当前扫描位置
+            sweep_x = std::max(sweep_x, event.x);
+
+            if (event.kind == Insert) {
+                auto it = status.insert(Slot{event.edge}).first;
+                handles[event.edge] = it;
+                through(it, ring_[left[event.edge]]);
+                if (it != status.begin()) {
+                    neighbours(std::prev(it)->edge, event.edge);
+                }
+                if (std::next(it) != status.end()) {
+                    neighbours(event.edge, std::next(it)->edge);
+                }
+            } else if (event.kind == Remove) {
+                auto it = handles[event.edge];
+                if (it == status.end()) {
+                    continue;
+                }
+                through(it, ring_[right[event.edge]]);
+                if (it != status.begin() && std::next(it) != status.end()) {
+                    neighbours(std::prev(it)->edge, std::next(it)->edge);
+                }
+                status.erase(it);
+                handles[event.edge] = status.end();
+            } else {
+                int lower = event.edge, upper = event.other;
+                auto lower_it = handles[lower];
+                auto upper_it = handles[upper];
+                uint64_t key = (static_cast<uint64_t>(std::min(lower, upper)) << 32) |
+                               static_cast<uint64_t>(std::max(lower, upper));
+                // 两条边已交换过，或已不再相邻（其中一条已删除）时该事件作废
+                if (crossed.count(key) || lower_it == status.end() || upper_it == status.end() ||
+                    std::next(lower_it) != upper_it) {
+                    continue;
+                }
+                crossed.insert(key);
+                lower_it->edge = upper;
+                upper_it->edge = lower;
+                handles[upper] = lower_it;
+                handles[lower] = upper_it;
+                if (lower_it != status.begin()) {
+                    neighbours(std::prev(lower_it)->edge, upper);
+                }
+                if (std::next(upper_it) != status.end()) {
+                    neighbours(lower, std::next(upper_it)->edge);
+                }
+            }
+        }
+    }
+
+    void addSplit(int edge, double t, int id) {
+        splits_[edge].push_back({t, id});
+        intersections_++;
+    }
+
+    /**
+     * 求两条不相邻边的交点或重叠部分，并记录拆分点
+     */
+    void intersect(int e, int f) {
+        int n = static_cast<int>(ring_.size());
+        const Point& p = ring_[e];
+        const Point& p2 = ring_[(e + 1) % n];
+        const Point& q = ring_[f];
+        const Point& q2 = ring_[(f + 1) % n];
+
+        double rx = p2.x() - p.x(), ry = p2.y() - p.y();
+        double sx = q2.x() - q.x(), sy = q2.y() - q.y();
+        double qpx = q.x() - p.x(), qpy = q.y() - p.y();
+        double r_length = std::sqrt(rx * rx + ry * ry);
+        double s_length = std::sqrt(sx * sx + sy * sy);
+        if (r_length == 0.0 || s_length == 0.0) {
+            return;
+        }
+        double t_epsilon = epsilon_ / r_length;
+        double u_epsilon = epsilon_ / s_length;
+        double denominator = rx * sy - ry * sx;
+
+        if (std::abs(denominator) > 1e-12 * r_length * s_length) {
+            double t = (qpx * sy - qpy * sx) / denominator;
+            double u = (qpx * ry - qpy * rx) / denominator;
+            if (t < -t_epsilon || t > 1 + t_epsilon || u < -u_epsilon || u > 1 + u_epsilon) {
+                return;
+            }
+
+            int on_e = t <= t_epsilon ? vertex_ids_[e] : (t >= 1 - t_epsilon ? vertex_ids_[(e + 1) % n] : -1);
+            int on_f = u <= u_epsilon ? vertex_ids_[f] : (u >= 1 - u_epsilon ? vertex_ids_[(f + 1) % n] : -1);
+            if (on_e >= 0 && on_f >= 0) {
+                // 顶点与顶点相接已在合并重合顶点时处理
+                return;
+            }
+            if (on_e >= 0) {
+                addSplit(f, u, on_e);
+            } else if (on_f >= 0) {
+                addSplit(e, t, on_f);
+            } else {
+                int id = static_cast<int>(points_.size());
+                points_.push_back(Point(p.x() + rx * t, p.y() + ry * t));
+                splits_[e].push_back({t, id});
+                splits_[f].push_back({u, id});
+                intersections_++;
+            }
+            return;
+        }
+
+        // 平行：只处理共线重叠，把一条边落在另一条边内部的端点记为拆分点
+        if (std::abs(qpx * ry - qpy * rx) > epsilon_ * r_length) {
+            return;
+        }
+        auto project = [](const Point& x, const Point& origin, double dx, double dy, double length) {
+            return ((x.x() - origin.x()) * dx + (x.y() - origin.y()) * dy) / (length * length);
+        };
+        const int f_ends[2] = {f, (f + 1) % n};
+        for (int end : f_ends) {
+            double t = project(ring_[end], p, rx, ry, r_length);
+            if (t > t_epsilon && t < 1 - t_epsilon) {
+                addSplit(e, t, vertex_ids_[end]);
+            }
+        }
+        const int e_ends[2] = {e, (e + 1) % n};
+        for (int end : e_ends) {
+            double u = project(ring_[end], q, sx, sy, s_length);
+            if (u > u_epsilon && u < 1 - u_epsilon) {
+                addSplit(f, u, vertex_ids_[end]);
+            }
+        }
+    }
+
+    const std::vector<Point>& ring_;
+    std::vector<Point> points_;         // 原顶点 + 新交点
+    std::vector<int> vertex_ids_;       // 每个原顶点的点编号（重合顶点共用编号）
+    std::vector<std::vector<SplitPoint>> splits_;
+    double epsilon_;
+    int intersections_ = 0;
+    std::unordered_set<uint64_t> tested_;       // 已求交的边对
+    std::vector<std::pair<int, int>> pairs_;
+};
+
+/**
+ * 沿闭合序列行走，某个点第二次出现时把两次出现之间的部分切成一个独立的环
+ */
+std::vector<std::vector<int>> splitIntoRings(const std::vector<int>& sequence, size_t point_count) {
+    std::vector<std::vector<int>> rings;
+    std::vector<int> stack;
+    std::vector<int> position(point_count, -1);
+
+    for (int id : sequence) {
+        if (position[id] >= 0) {
+            size_t start = position[id];
+            rings.emplace_back(stack.begin() + start, stack.end());
+            for (size_t k = start + 1; k < stack.size(); ++k) {
+                position[stack[k]] = -1;
+            }
+            stack.resize(start + 1);
+            continue;
+        }
+        position[id] = static_cast<int>(stack.size());
+        stack.push_back(id);
+    }
+    rings.push_back(stack);
+    return rings;
+}
+
+}
+
+std::string RepairReport::summary() const {
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer),
+                  "重复顶点 %d 个，尖刺 %d 个，自交点 %d 个，丢弃环 %d 个（面积 %g）",
+                  duplicate_vertices, spikes, intersections, discarded_rings, discarded_area);
+    return buffer;
+}
+
+std::vector<std::pair<int, int>> PolygonRepair::findIntersectingEdges(const std::vector<Point>& ring) {
+    if (ring.size() < 4) {
+        return {};
+    }
+    IntersectionFinder finder(ring, ringTolerance(ring));
+    finder.run();
+    std::vector<std::pair<int, int>> pairs = finder.pairs();
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+bool PolygonRepair::repair(Polygon_2& polygon, RepairReport& report) {
+    std::vector<Point> ring(polygon.vertices_begin(), polygon.vertices_end());
+    if (ring.empty()) {
+        return false;
+    }
+
+    double epsilon = ringTolerance(ring);
+
+    removeDegeneracies(ring, epsilon, report);
+
+    if (ring.size() >= 4) {
+        IntersectionFinder finder(ring, epsilon);
+        int found = finder.run();
+        if (found > 0) {
+            report.intersections += found;
+            auto rings = splitIntoRings(finder.walk(), finder.points().size());
+
+            // 保留面积最大的环
+            size_t best = 0;
+            double best_area = -1.0;
+            double total_area = 0.0;
+            for (size_t i = 0; i < rings.size(); ++i) {
+                std::vector<Point> candidate;
+                for (int id : rings[i]) {
+                    candidate.push_back(finder.points()[id]);
+                }
+                double area = std::abs(signedArea(candidate));
+                total_area += area;
+                if (area > best_area) {
+                    best_area = area;
+                    best = i;
+                }
+            }
+
+            std::vector<Point> kept;
+            for (int id : rings[best]) {
+                kept.push_back(finder.points()[id]);
+            }
+            report.discarded_rings += static_cast<int>(rings.size()) - 1;
+            report.discarded_area += total_area - best_area;
+            ring.swap(kept);
+
+            removeDegeneracies(ring, epsilon, report);
+        }
+    }
+
+    if (report.changed()) {
+        polygon.clear();
+        for (const auto& p : ring) {
+            polygon.push_back(p);
+        }
+    }
+
+    return ring.size() >= 3 && std::abs(signedArea(ring)) > epsilon * epsilon;
+}
+
+}
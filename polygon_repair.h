@@ -0,0 +1,57 @@
+#pragma once
+
+#include "types.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace RoofOutline {
+
+/**
+ * 轮廓修复记录（每个轮廓一份）
+ */
+struct RepairReport {
+    int duplicate_vertices = 0;     // 删除的重复相邻顶点（零长边）
+    int spikes = 0;                 // 删除的尖刺顶点（来回重叠的两条边）
+    int intersections = 0;          // 发现并拆分的自交点（含边与顶点相接）
+    int discarded_rings = 0;        // 拆分后丢弃的较小环
+    double discarded_area = 0.0;    // 丢弃环的面积之和
+
+    /**
+     * 是否对轮廓做了任何修改
+     */
+    bool changed() const {
+        return duplicate_vertices > 0 || spikes > 0 || intersections > 0 || discarded_rings > 0;
+    }
+
+    /**
+     * 修改内容的简短描述（用于日志）
+     */
+    std::string summary() const;
+};
+
+/**
+ * 轮廓修复模块
+ * 删除重复顶点和尖刺，用 Bentley-Ottmann 扫描线找出自交点并在交点处把轮廓拆分成若干简单环，保留面积最大的环。
+ * 不改变多边形方向（方向由 Geometry::validateAndFixPolygon 统一处理）
+ */
+class PolygonRepair {
+public:
+    /**
+     * 修复轮廓
+     * @param polygon 输入多边形，修复结果原地写回
+     * @param report 输出修复记录
+     * @return 修复后是否仍是有效多边形（至少3个顶点且面积非零）
+     */
+    static bool repair(Polygon_2& polygon, RepairReport& report);
+
+    /**
+     * 找出需要在交点或相接点处拆分的不相邻边对（修复中的扫描线求交步骤）
+     * 两条边在内部交叉，或一条边的端点落在另一条边内部时计入；仅在共同端点处相接的边对不计入
+     * @param ring 轮廓顶点（不含重复相邻顶点），边 i 连接顶点 i 与 i+1
+     * @return 边对 (e, f)，e < f，按字典序排列
+     */
+    static std::vector<std::pair<int, int>> findIntersectingEdges(const std::vector<Point>& ring);
+};
+
+}
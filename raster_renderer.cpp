@@ -0,0 +1,724 @@
+#include "raster_renderer.h"
+#include "geometry.h"
+#include "logger.h"
+#include <fstream>
+#include <cmath>
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ROOF_OUTLINE_RASTER_SSE2 1
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace RoofOutline {
+
+namespace {
+
+// 与 SVGRenderer 一致的配色
+const uint32_t kBackgroundColor = 0xf8f8f8;
+const uint32_t kGrayFaceColor = 0x9e9e9e;
+const uint32_t kFaceColor = 0xe3f2fd;
+const uint32_t kOutlineColor = 0x1976d2;
+const uint32_t kRidgeColor = 0xd32f2f;
+const uint32_t kOverhangColor = 0x388e3c;
+const uint32_t kOffsetColor = 0xf57c00;
+const uint32_t kFaceStrokeColor = 0x666666;
+const uint32_t kWhite = 0xffffff;
+
+/**
+ * 将一条有向边的覆盖面积累加到扫描线缓冲区（面积累加法）
+ * 缓冲区坐标已平移到局部原点，x 保证非负且小于 stride - 1
+ */
+void accumulateLine(float* acc, int stride, int rows,
+                    double x0, double y0, double x1, double y1) {
+    if (std::abs(y0 - y1) < 1e-12) {
+        return;
+    }
+
+    double dir = 1.0;
+    if (y0 > y1) {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+        dir = -1.0;
+    }
+
+    double dxdy = (x1 - x0) / (y1 - y0);
+    double x = x0;
+    int y_start = 0;
+    if (y0 < 0) {
+        x -= y0 * dxdy;
+    } else {
+        y_start = static_cast<int>(y0);
+    }
+    int y_end = std::min(rows, static_cast<int>(std::ceil(y1)));
+
+    for (int y = y_start; y < y_end; ++y) {
+        float* line = acc + static_cast<size_t>(y) * stride;
+        double dy = std::min(static_cast<double>(y + 1), y1) - std::max(static_cast<double>(y), y0);
+        double x_next = x + dxdy * dy;
+        double d = dy * dir;
+
+        double xa = std::max(0.0, std::min(x, x_next));
+        double xb = std::max(0.0, std::max(x, x_next));
+        double xa_floor = std::floor(xa);
+        int xai = static_cast<int>(xa_floor);
+        double xb_ceil = std::ceil(xb);
+        int xbi = static_cast<int>(xb_ceil);
+
+        if (xbi <= xai + 1) {
+            // 该行内线段只跨越一个像素
+            double xm = 0.5 * (xa + xb) - xa_floor;
+            line[xai] += static_cast<float>(d - d * xm);
+            line[xai + 1] += static_cast<float>(d * xm);
+        } else {
+            // 跨越多个像素：首尾像素按三角形面积分配，中间按斜率均分
+            double s = 1.0 / (xb - xa);
+            double xa_frac = xa - xa_floor;
+            double a0 = 0.5 * s * (1.0 - xa_frac) * (1.0 - xa_frac);
+            double xb_frac = xb - xb_ceil + 1.0;
+            double am = 0.5 * s * xb_frac * xb_frac;
+
+            line[xai] += static_cast<float>(d * a0);
+            if (xbi == xai + 2) {
+                line[xai + 1] += static_cast<float>(d * (1.0 - a0 - am));
+            } else {
+                double a1 = s * (1.5 - xa_frac);
+                line[xai + 1] += static_cast<float>(d * (a1 - a0));
+                for (int xi = xai + 2; xi < xbi - 1; ++xi) {
+                    line[xi] += static_cast<float>(d * s);
+                }
+                double a2 = a1 + (xbi - xai - 3) * s;
+                line[xbi - 1] += static_cast<float>(d * (1.0 - a2 - am));
+            }
+            line[xbi] += static_cast<float>(d * am);
+        }
+        x = x_next;
+    }
+}
+
+/**
+ * 对一行累加值做前缀和，得到每个像素的覆盖率 [0, 1]
+ * 读取的同时将累加缓冲区清零，供下一个形状直接复用
+ * @param n 像素数（必须是4的倍数）
+ */
+void accumulateCoverage(float* acc, float* coverage, int n) {
+#ifdef ROOF_OUTLINE_RASTER_SSE2
+    const __m128 sign_mask = _mm_set1_ps(-0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    __m128 offset = _mm_setzero_ps();
+    for (int i = 0; i < n; i += 4) {
+        __m128 x = _mm_loadu_ps(acc + i);
+        _mm_storeu_ps(acc + i, _mm_setzero_ps());
+        // 寄存器内前缀和：[a0, a0+a1, a0+a1+a2, a0+a1+a2+a3]
+        x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 4)));
+        x = _mm_add_ps(x, _mm_shuffle_ps(_mm_setzero_ps(), x, 0x40));
+        x = _mm_add_ps(x, offset);
+        __m128 y = _mm_min_ps(_mm_andnot_ps(sign_mask, x), one);
+        _mm_storeu_ps(coverage + i, y);
+        offset = _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+#else
+    float sum = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        sum += acc[i];
+        acc[i] = 0.0f;
+        coverage[i] = std::min(std::abs(sum), 1.0f);
+    }
+#endif
+}
+
+/**
+ * 生成圆形轮廓（与线段四边形保持相同的环绕方向）
+ * 缩略图中的圆半径只有几个像素，分段数随半径增加即可
+ */
+std::vector<std::pair<double, double>> makeCircle(double cx, double cy, double r) {
+    int segments = std::max(6, std::min(16, static_cast<int>(std::ceil(r * 3.0))));
+    std::vector<std::pair<double, double>> circle;
+    circle.reserve(segments);
+    for (int i = 0; i < segments; ++i) {
+        double a = -2.0 * M_PI * i / segments;
+        circle.push_back({cx + r * std::cos(a), cy + r * std::sin(a)});
+    }
+    return circle;
+}
+
+// ---- PNG / zlib 编码 ----
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    void writeBits(uint32_t value, int count) {
+        bit_buffer_ |= value << bit_count_;
+        bit_count_ += count;
+        while (bit_count_ >= 8) {
+            out_.push_back(static_cast<uint8_t>(bit_buffer_ & 0xff));
+            bit_buffer_ >>= 8;
+            bit_count_ -= 8;
+        }
+    }
+
+    // Huffman码需按高位在前写入
+    void writeCode(uint32_t code, int length) {
+        uint32_t reversed = 0;
+        for (int i = 0; i < length; ++i) {
+            reversed = (reversed << 1) | ((code >> i) & 1);
+        }
+        writeBits(reversed, length);
+    }
+
+    void flush() {
+        if (bit_count_ > 0) {
+            out_.push_back(static_cast<uint8_t>(bit_buffer_ & 0xff));
+        }
+        bit_buffer_ = 0;
+        bit_count_ = 0;
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+    uint32_t bit_buffer_ = 0;
+    int bit_count_ = 0;
+};
+
+// 固定Huffman表中的字面量/长度符号
+void writeFixedSymbol(BitWriter& bits, int symbol) {
+    if (symbol < 144) {
+        bits.writeCode(0x30 + symbol, 8);
+    } else if (symbol < 256) {
+        bits.writeCode(0x190 + (symbol - 144), 9);
+    } else if (symbol < 280) {
+        bits.writeCode(symbol - 256, 7);
+    } else {
+        bits.writeCode(0xc0 + (symbol - 280), 8);
+    }
+}
+
+void writeMatch(BitWriter& bits, int length, int distance) {
+    static const int kLengthBase[] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+    };
+    static const int kLengthExtra[] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+    };
+    static const int kDistBase[] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+    };
+    static const int kDistExtra[] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+    };
+
+    int li = 28;
+    while (kLengthBase[li] > length) {
+        --li;
+    }
+    writeFixedSymbol(bits, 257 + li);
+    bits.writeBits(length - kLengthBase[li], kLengthExtra[li]);
+
+    int di = 29;
+    while (kDistBase[di] > distance) {
+        --di;
+    }
+    bits.writeCode(di, 5);
+    bits.writeBits(distance - kDistBase[di], kDistExtra[di]);
+}
+
+/**
+ * 计算 data[pos..] 与 data[pos - distance..] 的公共前缀长度（每次比较8字节）
+ */
+int matchLength(const uint8_t* data, size_t size, size_t pos, size_t distance, int max_length) {
+    int limit = static_cast<int>(std::min(static_cast<size_t>(max_length), size - pos));
+    const uint8_t* cur = data + pos;
+    const uint8_t* ref = cur - distance;
+    int length = 0;
+    while (length + 8 <= limit) {
+        uint64_t a, b;
+        std::memcpy(&a, cur + length, 8);
+        std::memcpy(&b, ref + length, 8);
+        if (a != b) {
+            break;
+        }
+        length += 8;
+    }
+    while (length < limit && cur[length] == ref[length]) {
+        ++length;
+    }
+    return length;
+}
+
+/**
+ * zlib压缩（固定Huffman + 重复前一像素/前一行的LZ77匹配）
+ * 缩略图以大面积纯色为主，这种简单策略已能获得较好的压缩率
+ */
+void zlibCompress(const std::vector<uint8_t>& data, size_t row_length, std::vector<uint8_t>& out) {
+    const int max_match = 258;
+    const size_t max_distance = 32768;
+
+    out.push_back(0x78);
+    out.push_back(0x01);
+
+    BitWriter bits(out);
+    bits.writeBits(1, 1);  // BFINAL
+    bits.writeBits(1, 2);  // BTYPE = 固定Huffman
+
+    size_t candidates[2] = {4, row_length};
+    size_t i = 0;
+    while (i < data.size()) {
+        int best_length = 0;
+        size_t best_distance = 0;
+        for (size_t distance : candidates) {
+            if (best_length == max_match || distance > i || distance > max_distance) {
+                continue;
+            }
+            int length = matchLength(data.data(), data.size(), i, distance, max_match);
+            if (length > best_length) {
+                best_length = length;
+                best_distance = distance;
+            }
+        }
+
+        if (best_length >= 3) {
+            writeMatch(bits, best_length, static_cast<int>(best_distance));
+            i += best_length;
+        } else {
+            writeFixedSymbol(bits, data[i]);
+            ++i;
+        }
+    }
+    writeFixedSymbol(bits, 256);
+    bits.flush();
+
+    // Adler-32：每5552字节取一次模即可保证不溢出
+    uint32_t a = 1, b = 0;
+    for (size_t pos = 0; pos < data.size();) {
+        size_t block_end = std::min(data.size(), pos + 5552);
+        for (; pos < block_end; ++pos) {
+            a += data[pos];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    uint32_t adler = (b << 16) | a;
+    out.push_back(static_cast<uint8_t>(adler >> 24));
+    out.push_back(static_cast<uint8_t>(adler >> 16));
+    out.push_back(static_cast<uint8_t>(adler >> 8));
+    out.push_back(static_cast<uint8_t>(adler));
+}
+
+uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            t[n] = c;
+        }
+        return t;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+void writeChunk(std::vector<uint8_t>& png, const char* type, const std::vector<uint8_t>& data) {
+    uint32_t length = static_cast<uint32_t>(data.size());
+    png.push_back(static_cast<uint8_t>(length >> 24));
+    png.push_back(static_cast<uint8_t>(length >> 16));
+    png.push_back(static_cast<uint8_t>(length >> 8));
+    png.push_back(static_cast<uint8_t>(length));
+
+    size_t type_pos = png.size();
+    png.insert(png.end(), type, type + 4);
+    png.insert(png.end(), data.begin(), data.end());
+
+    uint32_t crc = crc32(png.data() + type_pos, 4 + data.size());
+    png.push_back(static_cast<uint8_t>(crc >> 24));
+    png.push_back(static_cast<uint8_t>(crc >> 16));
+    png.push_back(static_cast<uint8_t>(crc >> 8));
+    png.push_back(static_cast<uint8_t>(crc));
+}
+
+}
+
+void RasterRenderer::clear(RasterImage& image, int width, int height, uint32_t rgb) {
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(static_cast<size_t>(width) * height * 4);
+    if (image.pixels.empty()) {
+        return;
+    }
+
+    // 先填充第一行，再整行复制
+    size_t row_bytes = static_cast<size_t>(width) * 4;
+    for (size_t i = 0; i < row_bytes; i += 4) {
+        image.pixels[i] = static_cast<uint8_t>(rgb >> 16);
+        image.pixels[i + 1] = static_cast<uint8_t>(rgb >> 8);
+        image.pixels[i + 2] = static_cast<uint8_t>(rgb);
+        image.pixels[i + 3] = 255;
+    }
+    for (int y = 1; y < height; ++y) {
+        std::memcpy(image.pixels.data() + y * row_bytes, image.pixels.data(), row_bytes);
+    }
+}
+
+void RasterRenderer::fillContours(
+    RasterImage& image,
+    const std::vector<Contour>& contours,
+    uint32_t rgb,
+    double opacity
+) {
+    // 计算包围盒：x 方向完整覆盖（保证缓冲区索引非负），y 方向裁剪到画布
+    double min_x = 0, max_x = 0, min_y = 0, max_y = 0;
+    bool first = true;
+    for (const auto& contour : contours) {
+        for (const auto& p : contour) {
+            if (first) {
+                min_x = max_x = p.first;
+                min_y = max_y = p.second;
+                first = false;
+            } else {
+                min_x = std::min(min_x, p.first);
+                max_x = std::max(max_x, p.first);
+                min_y = std::min(min_y, p.second);
+                max_y = std::max(max_y, p.second);
+            }
+        }
+    }
+    if (first) {
+        return;
+    }
+
+    int origin_x = static_cast<int>(std::floor(min_x));
+    int origin_y = std::max(0, static_cast<int>(std::floor(min_y)));
+    int end_x = static_cast<int>(std::ceil(max_x));
+    int end_y = std::min(image.height, static_cast<int>(std::ceil(max_y)));
+    if (origin_y >= end_y || end_x < 0 || origin_x >= image.width) {
+        return;
+    }
+
+    int rows = end_y - origin_y;
+    int stride = (end_x - origin_x + 2 + 3) & ~3;
+
+    // 每个线程复用暂存缓冲区，避免每个形状都分配内存（读取覆盖率时已清零）
+    thread_local std::vector<float> accumulation;
+    thread_local std::vector<float> coverage;
+    if (accumulation.size() < static_cast<size_t>(stride) * rows) {
+        accumulation.resize(static_cast<size_t>(stride) * rows, 0.0f);
+    }
+    if (coverage.size() < static_cast<size_t>(stride)) {
+        coverage.resize(stride);
+    }
+
+    for (const auto& contour : contours) {
+        for (size_t i = 0; i < contour.size(); ++i) {
+            const auto& p0 = contour[i];
+            const auto& p1 = contour[(i + 1) % contour.size()];
+            accumulateLine(accumulation.data(), stride, rows,
+                           p0.first - origin_x, p0.second - origin_y,
+                           p1.first - origin_x, p1.second - origin_y);
+        }
+    }
+
+    float src[4] = {
+        static_cast<float>((rgb >> 16) & 0xff),
+        static_cast<float>((rgb >> 8) & 0xff),
+        static_cast<float>(rgb & 0xff),
+        255.0f
+    };
+    float alpha_scale = static_cast<float>(opacity);
+
+    // 只合成落在画布内的列
+    int col_begin = std::max(0, -origin_x);
+    int col_end = std::min(stride, image.width - origin_x);
+
+    for (int row = 0; row < rows; ++row) {
+        accumulateCoverage(accumulation.data() + static_cast<size_t>(row) * stride, coverage.data(), stride);
+
+        uint8_t* dst = image.pixels.data() + static_cast<size_t>(origin_y + row) * image.width * 4;
+        int col = col_begin;
+#ifdef ROOF_OUTLINE_RASTER_SSE2
+        const __m128 color = _mm_loadu_ps(src);
+        const __m128 alpha_scale4 = _mm_set1_ps(alpha_scale);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128i zero = _mm_setzero_si128();
+        for (; col + 4 <= col_end; col += 4) {
+            __m128 a = _mm_mul_ps(_mm_loadu_ps(coverage.data() + col), alpha_scale4);
+            if (_mm_movemask_ps(_mm_cmpgt_ps(a, _mm_setzero_ps())) == 0) {
+                continue;
+            }
+
+            // 一次处理4个像素，每个像素的RGBA四通道共用同一个alpha
+            uint8_t* px = dst + static_cast<size_t>(origin_x + col) * 4;
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(px));
+            __m128i lo16 = _mm_unpacklo_epi8(bytes, zero);
+            __m128i hi16 = _mm_unpackhi_epi8(bytes, zero);
+            __m128 p0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo16, zero));
+            __m128 p1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo16, zero));
+            __m128 p2 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi16, zero));
+            __m128 p3 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi16, zero));
+
+            p0 = _mm_add_ps(p0, _mm_mul_ps(_mm_sub_ps(color, p0), _mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0))));
+            p1 = _mm_add_ps(p1, _mm_mul_ps(_mm_sub_ps(color, p1), _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1))));
+            p2 = _mm_add_ps(p2, _mm_mul_ps(_mm_sub_ps(color, p2), _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2))));
+            p3 = _mm_add_ps(p3, _mm_mul_ps(_mm_sub_ps(color, p3), _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3))));
+
+            __m128i q01 = _mm_packs_epi32(_mm_cvttps_epi32(_mm_add_ps(p0, half)), _mm_cvttps_epi32(_mm_add_ps(p1, half)));
+            __m128i q23 = _mm_packs_epi32(_mm_cvttps_epi32(_mm_add_ps(p2, half)), _mm_cvttps_epi32(_mm_add_ps(p3, half)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(px), _mm_packus_epi16(q01, q23));
+        }
+#endif
+        for (; col < col_end; ++col) {
+            float a = coverage[col] * alpha_scale;
+            if (a <= 0.0f) {
+                continue;
+            }
+            uint8_t* px = dst + static_cast<size_t>(origin_x + col) * 4;
+            for (int c = 0; c < 4; ++c) {
+                px[c] = static_cast<uint8_t>(px[c] + (src[c] - px[c]) * a + 0.5f);
+            }
+        }
+    }
+}
+
+void RasterRenderer::strokeSegments(
+    RasterImage& image,
+    const std::vector<std::pair<std::pair<double, double>, std::pair<double, double>>>& segments,
+    double width,
+    uint32_t rgb,
+    double opacity
+) {
+    double half_width = width * 0.5;
+    std::vector<Contour> contours;
+    contours.reserve(segments.size() * 3);
+
+    for (const auto& [p1, p2] : segments) {
+        double dx = p2.first - p1.first;
+        double dy = p2.second - p1.second;
+        double length = std::sqrt(dx * dx + dy * dy);
+
+        if (length > 1e-9) {
+            // 线段扩展为四边形，所有四边形保持相同环绕方向以便非零规则合并
+            double nx = -dy / length * half_width;
+            double ny = dx / length * half_width;
+            contours.push_back({
+                {p1.first + nx, p1.second + ny},
+                {p2.first + nx, p2.second + ny},
+                {p2.first - nx, p2.second - ny},
+                {p1.first - nx, p1.second - ny}
+            });
+        }
+
+        // 圆头线帽（同时起到圆角连接的作用）
+        contours.push_back(makeCircle(p1.first, p1.second, half_width));
+        contours.push_back(makeCircle(p2.first, p2.second, half_width));
+    }
+
+    fillContours(image, contours, rgb, opacity);
+}
+
+void RasterRenderer::strokeOffsets(
+    RasterImage& image,
+    const std::vector<OffsetOutline>& offsets,
+    bool exterior,
+    const CoordinateTransform& transform,
+    uint32_t rgb
+) {
+    std::vector<std::pair<std::pair<double, double>, std::pair<double, double>>> segments;
+    for (const auto& outline : offsets) {
+        if ((outline.distance < 0) != exterior) {
+            continue;
+        }
+        for (const auto& ring : outline.rings) {
+            for (size_t i = 0; i < ring.size(); ++i) {
+                const auto& p = ring[i];
+                const auto& q = ring[(i + 1) % ring.size()];
+                segments.push_back({
+                    {transform.toSVGX(p.first), transform.toSVGY(p.second)},
+                    {transform.toSVGX(q.first), transform.toSVGY(q.second)}
+                });
+            }
+        }
+    }
+    if (!segments.empty()) {
+        strokeSegments(image, segments, 1.5, rgb, 1.0);
+    }
+}
+
+bool RasterRenderer::renderRidgeView(
+    RasterImage& image,
+    const Polygon_2& polygon,
+    const SsPtr& skeleton,
+    const CoordinateTransform& transform,
+    const CoordinateTransform& gray_transform,
+    const std::vector<std::pair<double, double>>& gray_vertices,
+    const std::vector<OffsetOutline>& offsets
+) {
+    if (!skeleton) {
+        ROOF_LOG_ERROR("png", "无法渲染缩略图：直骨架为空");
+        return false;
+    }
+
+    clear(image, transform.getSVGWidth(), transform.getSVGHeight(), kBackgroundColor);
+
+    // 骨架分割的面
+    for (auto fit = skeleton->faces_begin(); fit != skeleton->faces_end(); ++fit) {
+        Contour face_pixels;
+        std::vector<std::pair<double, double>> face_svg_vertices;
+        auto he = fit->halfedge();
+        auto start = he;
+        do {
+            double x = he->vertex()->point().x();
+            double y = he->vertex()->point().y();
+            face_pixels.push_back({transform.toSVGX(x), transform.toSVGY(y)});
+            face_svg_vertices.push_back({gray_transform.toSVGX(x), gray_transform.toSVGY(y)});
+            he = he->next();
+        } while (he != start);
+
+        bool is_gray = Geometry::containsGrayVertex(face_svg_vertices, gray_vertices);
+        fillContours(image, {face_pixels}, is_gray ? kGrayFaceColor : kFaceColor, 0.8);
+    }
+
+    // 挑檐轮廓
+    strokeOffsets(image, offsets, true, transform, kOverhangColor);
+
+    // 屋顶外轮廓
+    std::vector<std::pair<std::pair<double, double>, std::pair<double, double>>> outline;
+    for (auto it = polygon.vertices_begin(); it != polygon.vertices_end(); ++it) {
+        auto next = std::next(it);
+        if (next == polygon.vertices_end()) {
+            next = polygon.vertices_begin();
+        }
+        outline.push_back({
+            {transform.toSVGX(it->x()), transform.toSVGY(it->y())},
+            {transform.toSVGX(next->x()), transform.toSVGY(next->y())}
+        });
+    }
+    strokeSegments(image, outline, 2.0, kOutlineColor, 1.0);
+
+    // 向内偏移轮廓
+    strokeOffsets(image, offsets, false, transform, kOffsetColor);
+
+    // 屋脊线（骨架边）
+    std::vector<std::pair<std::pair<double, double>, std::pair<double, double>>> ridges;
+    for (auto hit = skeleton->halfedges_begin(); hit != skeleton->halfedges_end(); ++hit) {
+        if (hit < hit->opposite()) {
+            auto v1 = hit->vertex();
+            auto v2 = hit->opposite()->vertex();
+            ridges.push_back({
+                {transform.toSVGX(v1->point().x()), transform.toSVGY(v1->point().y())},
+                {transform.toSVGX(v2->point().x()), transform.toSVGY(v2->point().y())}
+            });
+        }
+    }
+    strokeSegments(image, ridges, 2.5, kRidgeColor, 1.0);
+
+    // 骨架顶点（白色描边的圆点）
+    for (auto vit = skeleton->vertices_begin(); vit != skeleton->vertices_end(); ++vit) {
+        double x = transform.toSVGX(vit->point().x());
+        double y = transform.toSVGY(vit->point().y());
+        double r = vit->is_skeleton() ? 4.0 : 3.0;
+
+        fillContours(image, {makeCircle(x, y, r + 0.5)}, kWhite, 1.0);
+        fillContours(image, {makeCircle(x, y, r - 0.5)},
+                     vit->is_skeleton() ? kRidgeColor : kOutlineColor, 1.0);
+    }
+
+    return true;
+}
+
+bool RasterRenderer::renderUnfoldedView(
+    RasterImage& image,
+    const std::vector<std::pair<std::vector<std::pair<double, double>>, bool>>& unfolded_faces,
+    const CoordinateTransform& transform
+) {
+    clear(image, transform.getSVGWidth(), transform.getSVGHeight(), kBackgroundColor);
+
+    // 展开的屋面
+    std::vector<std::pair<std::pair<double, double>, std::pair<double, double>>> edges;
+    for (const auto& [vertices, is_gray] : unfolded_faces) {
+        Contour face_pixels;
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            const auto& v1 = vertices[i];
+            const auto& v2 = vertices[(i + 1) % vertices.size()];
+            face_pixels.push_back({transform.toSVGX(v1.first), transform.toSVGY(v1.second)});
+            edges.push_back({
+                {transform.toSVGX(v1.first), transform.toSVGY(v1.second)},
+                {transform.toSVGX(v2.first), transform.toSVGY(v2.second)}
+            });
+        }
+        fillContours(image, {face_pixels}, is_gray ? kGrayFaceColor : kFaceColor, 0.85);
+    }
+
+    // 面描边与边缘线：各自作为一个整体合成，避免逐面处理的开销
+    strokeSegments(image, edges, 1.5, kFaceStrokeColor, 0.85);
+    strokeSegments(image, edges, 2.0, kOutlineColor, 0.7);
+
+    return true;
+}
+
+void RasterRenderer::encodePNG(const RasterImage& image, std::vector<uint8_t>& png) {
+    static const uint8_t kSignature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    png.assign(kSignature, kSignature + sizeof(kSignature));
+
+    // IHDR：8位RGBA
+    std::vector<uint8_t> header = {
+        static_cast<uint8_t>(image.width >> 24), static_cast<uint8_t>(image.width >> 16),
+        static_cast<uint8_t>(image.width >> 8), static_cast<uint8_t>(image.width),
+        static_cast<uint8_t>(image.height >> 24), static_cast<uint8_t>(image.height >> 16),
+        static_cast<uint8_t>(image.height >> 8), static_cast<uint8_t>(image.height),
+        8, 6, 0, 0, 0
+    };
+    writeChunk(png, "IHDR", header);
+
+    // 每行使用Sub滤波，纯色区域变为0，便于压缩
+    size_t row_bytes = static_cast<size_t>(image.width) * 4;
+    std::vector<uint8_t> filtered((row_bytes + 1) * image.height);
+    for (int y = 0; y < image.height; ++y) {
+        const uint8_t* row = image.pixels.data() + y * row_bytes;
+        uint8_t* out = filtered.data() + y * (row_bytes + 1);
+        out[0] = 1;
+        for (size_t i = 0; i < row_bytes; ++i) {
+            uint8_t left = i >= 4 ? row[i - 4] : 0;
+            out[i + 1] = static_cast<uint8_t>(row[i] - left);
+        }
+    }
+
+    std::vector<uint8_t> compressed;
+    zlibCompress(filtered, row_bytes + 1, compressed);
+    writeChunk(png, "IDAT", compressed);
+    writeChunk(png, "IEND", {});
+}
+
+bool RasterRenderer::writePNG(const std::string& filename, const RasterImage& image) {
+    std::vector<uint8_t> png;
+    encodePNG(image, png);
+
+    std::ofstream png_file(filename, std::ios::binary);
+    if (!png_file) {
+        ROOF_LOG_ERROR("png", "无法创建 PNG 文件: %s", filename.c_str());
+        return false;
+    }
+    png_file.write(reinterpret_cast<const char*>(png.data()), png.size());
+    png_file.close();
+
+    ROOF_LOG_INFO("png", "✓ PNG 缩略图已生成: %s", filename.c_str());
+    return true;
+}
+
+}
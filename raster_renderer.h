@@ -0,0 +1,119 @@
+#pragma once
+
+#include "types.h"
+#include "coordinate_transform.h"
+#include "roof_offsets.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace RoofOutline {
+
+/**
+ * 内存中的RGBA位图（每像素4字节，按行存储）
+ */
+struct RasterImage {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> pixels;
+};
+
+/**
+ * 栅格渲染模块
+ * 直接在内存中生成缩略图（抗锯齿扫描线填充）并编码为PNG，
+ * 配色与 SVGRenderer 保持一致
+ */
+class RasterRenderer {
+public:
+    /**
+     * 渲染屋脊线俯视图缩略图
+     * @param image 输出位图（尺寸取自 transform）
+     * @param polygon 多边形
+     * @param skeleton 直骨架
+     * @param transform 像素坐标转换器
+     * @param gray_transform 灰色顶点所在的坐标转换器（与SVG俯视图一致）
+     * @param gray_vertices 需要标记为灰色的特殊顶点（SVG坐标）
+     * @param offsets 附加绘制的偏移轮廓（图层顺序与SVG俯视图一致）
+     * @return 是否成功
+     */
+    static bool renderRidgeView(
+        RasterImage& image,
+        const Polygon_2& polygon,
+        const SsPtr& skeleton,
+        const CoordinateTransform& transform,
+        const CoordinateTransform& gray_transform,
+        const std::vector<std::pair<double, double>>& gray_vertices,
+        const std::vector<OffsetOutline>& offsets = std::vector<OffsetOutline>()
+    );
+
+    /**
+     * 渲染屋顶展开图缩略图
+     * @param image 输出位图（尺寸取自 transform）
+     * @param unfolded_faces 展开后的面信息
+     * @param transform 像素坐标转换器
+     * @return 是否成功
+     */
+    static bool renderUnfoldedView(
+        RasterImage& image,
+        const std::vector<std::pair<std::vector<std::pair<double, double>>, bool>>& unfolded_faces,
+        const CoordinateTransform& transform
+    );
+
+    /**
+     * 将位图编码为PNG（内置deflate，无外部依赖）
+     * @param image 输入位图
+     * @param png 输出PNG字节流
+     */
+    static void encodePNG(const RasterImage& image, std::vector<uint8_t>& png);
+
+    /**
+     * 将位图写入PNG文件
+     * @param filename 输出文件名
+     * @param image 输入位图
+     * @return 是否成功
+     */
+    static bool writePNG(const std::string& filename, const RasterImage& image);
+
+private:
+    typedef std::vector<std::pair<double, double>> Contour;
+
+    /**
+     * 初始化画布并填充背景色
+     */
+    static void clear(RasterImage& image, int width, int height, uint32_t rgb);
+
+    /**
+     * 按非零环绕规则抗锯齿填充若干闭合轮廓（像素坐标）
+     */
+    static void fillContours(
+        RasterImage& image,
+        const std::vector<Contour>& contours,
+        uint32_t rgb,
+        double opacity
+    );
+
+    /**
+     * 以圆头线帽绘制若干线段（作为一个整体合成，重叠处不会叠加透明度）
+     */
+    static void strokeSegments(
+        RasterImage& image,
+        const std::vector<std::pair<std::pair<double, double>, std::pair<double, double>>>& segments,
+        double width,
+        uint32_t rgb,
+        double opacity
+    );
+
+    /**
+     * 绘制向内（exterior 为 false）或向外（exterior 为 true）的偏移轮廓
+     */
+    static void strokeOffsets(
+        RasterImage& image,
+        const std::vector<OffsetOutline>& offsets,
+        bool exterior,
+        const CoordinateTransform& transform,
+        uint32_t rgb
+    );
+};
+
+}
@@ -0,0 +1,1429 @@
+#include "rectilinear_skeleton.h"
+#include <cmath>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace RoofOutline {
+
+namespace {
+
+struct Vec {
+    double x;
+    double y;
+};
+
+Vec operator+(const Vec& a, const Vec& b) { return {a.x + b.x, a.y + b.y}; }
+Vec operator-(const Vec& a, const Vec& b) { return {a.x - b.x, a.y - b.y}; }
+Vec operator*(const Vec& a, double s) { return {a.x * s, a.y * s}; }
+double dot(const Vec& a, const Vec& b) { return a.x * b.x + a.y * b.y; }
+double cross(const Vec& a, const Vec& b) { return a.x * b.y - a.y * b.x; }
+double length(const Vec& a) { return std::sqrt(dot(a, a)); }
+
+/**
+ * 骨架节点（轮廓顶点或波前事件发生的位置）
+ */
+struct Node {
+    Vec position;
+    double time;
+};
+
+/**
+ * 骨架边：连接两个节点，分隔两条原始轮廓边对应的面
+ */
+struct Arc {
+    int from;
+    int to;
+    int face_a;
+    int face_b;
+};
+
+/**
+ * 波前顶点：从起始节点出发匀速运动，直到在某个事件中终止
+ */
+struct WavefrontVertex {
+    Vec start_position;
+    double start_time;
+    Vec velocity;
+    int prev;
+    int next;
+    int edge;               // 该顶点到 next 的波前边所在的原始轮廓边
+    int node;               // 起始骨架节点
+    bool alive;
+    unsigned version;       // 相邻关系变化时递增，使旧事件失效
+    unsigned split_stamp;   // 重新计算分裂事件时递增
+    double split_time;      // 已安排的最早分裂事件时刻
+    int ring;               // 所在波前环的编号
+};
+
+enum EventType {
+    EdgeCollapse = 0,   // 波前边长度缩短为0
+    Split = 1           // 凹顶点撞上对面的波前边
+};
+
+struct Event {
+    double time;
+    EventType type;
+    int vertex;
+    unsigned vertex_stamp;
+    int a;
+    unsigned a_version;
+    int b;
+    unsigned b_version;
+
+    bool operator>(const Event& other) const {
+        if (time != other.time) {
+            return time > other.time;
+        }
+        return type > other.type;
+    }
+};
+
+/**
+ * 二维支配查询树
+ * 按 (a, id) 排序的树堆，子树上维护 b、c、d 的极值用于剪枝；优先级由插入序号散列得到，结果与运行无关
+ */
+class DominanceTree {
+public:
+    struct Entry {
+        double a;
+        double b;
+        double c;
+        double d;
+        int id;
+    };
+
+    void insert(const Entry& entry);
+    void erase(const Entry& entry);
+
+    /**
+     * 在 a <= a_max、b >= b_min、c >= c_min 的条目中按 c 从小到大寻找第一个被 accept 接受的条目
+     * @param c_best 输入时为 c 的上界，接受条目后更新为该条目的 c
+     */
+    template <typename Accept>
+    void searchMinC(double a_max, double b_min, double c_min, double& c_best, Accept accept) const {
+        searchMinC(root_, a_max, b_min, c_min, c_best, accept);
+    }
+
+    /**
+     * 列出 a >= a_min、b <= b_max、c <= c_max、d > d_min 的条目
+     */
+    void report(double a_min, double b_max, double c_max, double d_min, std::vector<int>& ids) const;
+
+private:
+    struct Node {
+        Entry entry;
+        unsigned priority;
+        int left;
+        int right;
+        double min_b;
+        double max_b;
+        double min_c;
+        double max_c;
+        double max_d;
+    };
+
+    static bool before(const Entry& x, const Entry& y) {
+        return x.a < y.a || (x.a == y.a && x.id < y.id);
+    }
+
+    void pull(int x);
+    void split(int x, const Entry& key, bool inclusive, int& left, int& right);
+    int merge(int left, int right);
+
+    template <typename Accept>
+    void searchMinC(int x, double a_max, double b_min, double c_min, double& c_best, Accept& accept) const {
+        if (x < 0) {
+            return;
+        }
+        const Node& node = nodes_[x];
+        if (node.min_c >= c_best || node.max_c < c_min || node.max_b < b_min) {
+            return;
+        }
+        if (node.entry.a > a_max) {
+            searchMinC(node.left, a_max, b_min, c_min, c_best, accept);
+            return;
+        }
+        if (node.entry.b >= b_min && node.entry.c >= c_min && node.entry.c < c_best && accept(node.entry)) {
+            c_best = node.entry.c;
+        }
+        // 先进入 c 下界较小的子树，尽早收紧上界
+        int first = node.left;
+        int second = node.right;
+        if (first < 0 || (second >= 0 && nodes_[second].min_c < nodes_[first].min_c)) {
+            std::swap(first, second);
+        }
+        searchMinC(first, a_max, b_min, c_min, c_best, accept);
+        searchMinC(second, a_max, b_min, c_min, c_best, accept);
+    }
+
+    void report(int x, double a_min, double b_max, double c_max, double d_min, std::vector<int>& ids) const;
+
+    std::vector<Node> nodes_;
+    std::vector<int> free_;
+    int root_ = -1;
+    unsigned inserted_ = 0;
+};
+
+void DominanceTree::pull(int x) {
+    Node& node = nodes_[x];
+    node.min_b = node.max_b = node.entry.b;
+    node.min_c = node.max_c = node.entry.c;
+    node.max_d = node.entry.d;
+    for (int child : {node.left, node.right}) {
+        if (child >= 0) {
+            const Node& c = nodes_[child];
+            node.min_b = std::min(node.min_b, c.min_b);
+            node.max_b = std::max(node.max_b, c.max_b);
+            node.min_c = std::min(node.min_c, c.min_c);
+            node.max_c = std::max(node.max_c, c.max_c);
+            node.max_d = std::max(node.max_d, c.max_d);
+        }
+    }
+}
+
+void DominanceTree::split(int x, const Entry& key, bool inclusive, int& left, int& right) {
+    // inclusive 为真时与 key 相同的条目分到左侧
+    if (x < 0) {
+        left = right = -1;
+        return;
+    }
+    bool goes_left = inclusive ? !before(key, nodes_[x].entry) : before(nodes_[x].entry, key);
+    if (goes_left) {
+        split(nodes_[x].right, key, inclusive, nodes_[x].right, right);
+        left = x;
+    } else {
+        split(nodes_[x].left, key, inclusive, left, nodes_[x].left);
+        right = x;
+    }
+    pull(x);
+}
+
+int DominanceTree::merge(int left, int right) {
+    if (left < 0 || right < 0) {
+        return left < 0 ? right : left;
+    }
+    if (nodes_[left].priority > nodes_[right].priority) {
+        nodes_[left].right = merge(nodes_[left].right, right);
+        pull(left);
+        return left;
+    }
+    nodes_[right].left = merge(left, nodes_[right].left);
+    pull(right);
+    return right;
+}
+
+void DominanceTree::insert(const Entry& entry) {
+    int x;
+    if (free_.empty()) {
+        x = static_cast<int>(nodes_.size());
+        nodes_.emplace_back();
+    } else {
+        x = free_.back();
+        free_.pop_back();
+    }
+    unsigned h = ++inserted_ * 2654435761u;
+    h ^= h >> 16;
+    nodes_[x].entry = entry;
+    nodes_[x].priority = h * 2246822519u;
+    nodes_[x].left = -1;
+    nodes_[x].right = -1;
+    pull(x);
+
+    int left, right;
+    split(root_, entry, false, left, right);
+    root_ = merge(merge(left, x), right);
+}
+
+void DominanceTree::erase(const Entry& entry) {
+    int left, middle, right;
+    split(root_, entry, false, left, right);
+    split(right, entry, true, middle, right);
+    if (middle >= 0) {
+        free_.push_back(middle);
+    }
+    root_ = merge(left, right);
+}
+
+void DominanceTree::report(double a_min, double b_max, double c_max, double d_min, std::vector<int>& ids) const {
+    report(root_, a_min, b_max, c_max, d_min, ids);
+}
+
+void DominanceTree::report(int x, double a_min, double b_max, double c_max, double d_min, std::vector<int>& ids) const {
+    if (x < 0) {
+        return;
+    }
+    const Node& node = nodes_[x];
+    if (node.min_b > b_max || node.min_c > c_max || node.max_d <= d_min) {
+        return;
+    }
+    if (node.entry.a < a_min) {
+        report(node.right, a_min, b_max, c_max, d_min, ids);
+        return;
+    }
+    if (node.entry.b <= b_max && node.entry.c <= c_max && node.entry.d > d_min) {
+        ids.push_back(node.entry.id);
+    }
+    report(node.left, a_min, b_max, c_max, d_min, ids);
+    report(node.right, a_min, b_max, c_max, d_min, ids);
+}
+
+/**
+ * 波前边或凹顶点在某棵支配查询树中的条目
+ */
+struct IndexEntry {
+    int tree;
+    DominanceTree::Entry entry;
+};
+
+/**
+ * 凹顶点运动方向 (sx, sy) 与目标边走向对应的树编号
+ */
+int treeIndex(double sx, double sy, bool horizontal) {
+    return 2 * ((sx > 0 ? 1 : 0) + (sy > 0 ? 2 : 0)) + (horizontal ? 0 : 1);
+}
+
+/**
+ * 正交波前推进器
+ * 所有波前边都停留在原始边的平移线上，顶点速度为相邻两边内法向之和（共线时为法向本身）。
+ * 同一时刻的退化情况（零长边、反向重叠的尖刺、共线顶点）统一在 clean() 中局部消解。
+ *
+ * 分裂事件不再沿环扫描，而是按运动方向建立索引：凹顶点只沿四个对角方向运动，
+ * 同一方向的凹顶点整体平移，坐标 u = sx·x - t、w = sy·y - t 不随时间变化；
+ * 朝它们推进的波前边所在直线同样有不变量 l（直线到达时刻）。凹顶点撞上某条边的时刻为 (l - w) / 2，
+ * 而边的端点速度不超过 1，因此“可能撞上”可写成两个不变量上的支配条件：
+ *   u - w >= 边起点 + τ - l，u <= 边终点 - τ（τ 为边加入索引的时刻，此后条件只会变松）。
+ * 新建或运动变化的凹顶点在边索引中按到达时刻由近到远查找目标，
+ * 其余凹顶点只在有边变化时由凹顶点索引列出可能因此提前分裂的顶点
+ */
+class WavefrontPropagation {
+public:
+    explicit WavefrontPropagation(const std::vector<Vec>& contour);
+
+    bool run();
+
+    const std::vector<Node>& nodes() const { return nodes_; }
+    const std::vector<Arc>& arcs() const { return arcs_; }
+
+private:
+    Vec positionAt(int v, double t) const {
+        const WavefrontVertex& vertex = vertices_[v];
+        return vertex.start_position + vertex.velocity * (t - vertex.start_time);
+    }
+
+    int nodeAt(const Vec& position, double time);
+    uint64_t cellKey(long long cx, long long cy) const {
+        return static_cast<uint64_t>(cx) * 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(cy);
+    }
+    int createVertex(const Vec& position, double time, int node, int edge, int prev, int next);
+    void link(int a, int b);
+    void terminate(int v, int node);
+    void addRidge(int node_a, int node_b, int face_a, int face_b);
+    void updateVelocity(int v);
+    bool isReflex(int v) const;
+    void relabelSmallerRing(int a, int b);
+
+    void indexEdge(int v);
+    void indexReflex(int v);
+    void unindex(int v);
+
+    void processEdgeCollapse(const Event& event);
+    void processSplit(const Event& event);
+    bool clean();
+    void collapseRing(int v);
+    void reschedule();
+    void scheduleEdgeCollapse(int v);
+    void scheduleSplit(int v);
+    void scheduleSplitsOnto(int e);
+    bool splitCandidate(int v, int e, Event& event) const;
+    bool isValid(const Event& event) const;
+    bool isStaleSplit(const Event& event) const;
+
+    std::vector<Vec> directions_;       // 每条原始边的单位方向
+    std::vector<Vec> normals_;          // 每条原始边的单位内法向
+    std::vector<WavefrontVertex> vertices_;
+    std::vector<Node> nodes_;
+    std::vector<Arc> arcs_;
+    std::unordered_map<uint64_t, std::vector<int>> recent_nodes_;  // 当前时刻创建的节点（按容差网格分桶），用于合并重合事件
+    double recent_time_ = 0.0;
+    std::vector<int> touched_;          // 本次事件中新建或相邻关系变化的顶点
+    std::vector<unsigned> touched_marks_;
+    std::vector<unsigned> edge_marks_;
+    unsigned mark_ = 0;
+    int ring_count_ = 1;
+
+    // 按凹顶点运动方向 (sx, sy) 与目标边走向（水平 / 竖直）划分的 8 棵树：
+    // edge_trees_ 存放朝该方向凹顶点推进的波前边，reflex_trees_ 存放该方向的凹顶点
+    DominanceTree edge_trees_[8];
+    DominanceTree reflex_trees_[8];
+    std::vector<std::array<IndexEntry, 2>> edge_entries_;
+    std::vector<std::array<IndexEntry, 2>> reflex_entries_;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events_;
+    double now_ = 0.0;
+    double epsilon_ = 1e-9;
+};
+
+WavefrontPropagation::WavefrontPropagation(const std::vector<Vec>& contour) {
+    size_t n = contour.size();
+
+    double extent = 0.0;
+    for (const auto& p : contour) {
+        extent = std::max(extent, std::max(std::abs(p.x), std::abs(p.y)));
+    }
+    epsilon_ = 1e-9 * std::max(1.0, extent);
+
+    for (size_t i = 0; i < n; ++i) {
+        Vec d = contour[(i + 1) % n] - contour[i];
+        double len = length(d);
+        Vec dir = {d.x / len, d.y / len};
+        // 轴对齐边的方向取精确的单位向量
+        if (std::abs(d.y) <= epsilon_) {
+            dir = {d.x > 0 ? 1.0 : -1.0, 0.0};
+        } else {
+            dir = {0.0, d.y > 0 ? 1.0 : -1.0};
+        }
+        directions_.push_back(dir);
+        normals_.push_back({-dir.y, dir.x});
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        nodeAt(contour[i], 0.0);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        int prev = static_cast<int>((i + n - 1) % n);
+        int next = static_cast<int>((i + 1) % n);
+        createVertex(contour[i], 0.0, static_cast<int>(i), static_cast<int>(i), prev, next);
+    }
+}
+
+int WavefrontPropagation::nodeAt(const Vec& position, double time) {
+    if (time > recent_time_ + epsilon_) {
+        recent_nodes_.clear();
+        recent_time_ = time;
+    }
+
+    // 容差范围内的节点只可能落在相邻的网格中；有多个时取最早创建的
+    long long cx = static_cast<long long>(std::floor(position.x / epsilon_));
+    long long cy = static_cast<long long>(std::floor(position.y / epsilon_));
+    int found = -1;
+    for (long long dx = -1; dx <= 1; ++dx) {
+        for (long long dy = -1; dy <= 1; ++dy) {
+            auto it = recent_nodes_.find(cellKey(cx + dx, cy + dy));
+            if (it == recent_nodes_.end()) {
+                continue;
+            }
+            for (int id : it->second) {
+                const Vec delta = nodes_[id].position - position;
+                if (std::abs(delta.x) <= epsilon_ && std::abs(delta.y) <= epsilon_ && (found < 0 || id < found)) {
+                    found = id;
+                }
+            }
+        }
+    }
+    if (found >= 0) {
+        return found;
+    }
+
+    nodes_.push_back({position, time});
+    int id = static_cast<int>(nodes_.size() - 1);
+    recent_nodes_[cellKey(cx, cy)].push_back(id);
+    return id;
+}
+
+int WavefrontPropagation::createVertex(const Vec& position, double time, int node, int edge, int prev, int next) {
+    WavefrontVertex vertex;
+    vertex.start_position = position;
+    vertex.start_time = time;
+    vertex.velocity = {0.0, 0.0};
+    vertex.prev = prev;
+    vertex.next = next;
+    vertex.edge = edge;
+    vertex.node = node;
+    vertex.alive = true;
+    vertex.version = 0;
+    vertex.split_stamp = 0;
+    vertex.split_time = std::numeric_limits<double>::infinity();
+    // 新顶点与前驱同环；构造初始环时前驱尚未创建，统一为 0 号环
+    vertex.ring = prev < static_cast<int>(vertices_.size()) ? vertices_[prev].ring : 0;
+    vertices_.push_back(vertex);
+    touched_marks_.push_back(0);
+    edge_marks_.push_back(0);
+    IndexEntry none = {-1, {}};
+    edge_entries_.push_back({none, none});
+    reflex_entries_.push_back({none, none});
+
+    int id = static_cast<int>(vertices_.size() - 1);
+    touched_.push_back(id);
+    return id;
+}
+
+void WavefrontPropagation::link(int a, int b) {
+    vertices_[a].next = b;
+    vertices_[b].prev = a;
+    vertices_[a].version++;
+    vertices_[b].version++;
+    touched_.push_back(a);
+    touched_.push_back(b);
+}
+
+void WavefrontPropagation::terminate(int v, int node) {
+    WavefrontVertex& vertex = vertices_[v];
+    int face_in = vertices_[vertex.prev].edge;
+    if (vertex.node != node && face_in != vertex.edge) {
+        arcs_.push_back({vertex.node, node, face_in, vertex.edge});
+    }
+    vertex.alive = false;
+    vertex.version++;
+    unindex(v);
+}
+
+void WavefrontPropagation::addRidge(int node_a, int node_b, int face_a, int face_b) {
+    if (node_a != node_b && face_a != face_b) {
+        arcs_.push_back({node_a, node_b, face_a, face_b});
+    }
+}
+
+void WavefrontPropagation::updateVelocity(int v) {
+    WavefrontVertex& vertex = vertices_[v];
+    const Vec& n_in = normals_[vertices_[vertex.prev].edge];
+    const Vec& n_out = normals_[vertex.edge];
+
+    if (std::abs(dot(n_in, n_out)) < 0.5) {
+        // 相互垂直：沿45°方向运动
+        vertex.velocity = n_in + n_out;
+    } else if (dot(n_in, n_out) > 0) {
+        // 共线：沿法向运动
+        vertex.velocity = n_in;
+    } else {
+        // 反向（尖刺）只会在 clean() 中短暂出现
+        vertex.velocity = {0.0, 0.0};
+    }
+}
+
+bool WavefrontPropagation::isReflex(int v) const {
+    const WavefrontVertex& vertex = vertices_[v];
+    return cross(directions_[vertices_[vertex.prev].edge], directions_[vertex.edge]) < -0.5;
+}
+
+void WavefrontPropagation::relabelSmallerRing(int a, int b) {
+    // 两个环同步前进，先走完的一侧换用新编号，每个顶点被重新编号的次数为 O(log n)
+    int x = a;
+    int y = b;
+    while (true) {
+        x = vertices_[x].next;
+        y = vertices_[y].next;
+        if (x == b || y == a) {
+            return;
+        }
+        if (x == a || y == b) {
+            break;
+        }
+    }
+
+    int start = x == a ? a : b;
+    int ring = ring_count_++;
+    x = start;
+    do {
+        vertices_[x].ring = ring;
+        x = vertices_[x].next;
+    } while (x != start);
+}
+
+void WavefrontPropagation::indexEdge(int v) {
+    for (IndexEntry& item : edge_entries_[v]) {
+        if (item.tree >= 0) {
+            edge_trees_[item.tree].erase(item.entry);
+            item.tree = -1;
+        }
+    }
+    if (!vertices_[v].alive) {
+        return;
+    }
+
+    // 只有沿法向反方向运动的凹顶点会迎面撞上这条边，沿边方向的运动分量可正可负，各占一棵树
+    const Vec& normal = normals_[vertices_[v].edge];
+    bool horizontal = normal.x == 0.0;
+    Vec p = positionAt(v, now_);
+    Vec q = positionAt(vertices_[v].next, now_);
+    for (int k = 0; k < 2; ++k) {
+        double side = k == 0 ? -1.0 : 1.0;
+        double sx = horizontal ? side : -normal.x;
+        double sy = horizontal ? -normal.y : side;
+        double line = (horizontal ? sy * p.y : sx * p.x) + now_;
+        double s0 = horizontal ? sx * p.x : sy * p.y;
+        double s1 = horizontal ? sx * q.x : sy * q.y;
+
+        IndexEntry& item = edge_entries_[v][k];
+        item.tree = treeIndex(sx, sy, horizontal);
+        item.entry = {std::min(s0, s1) + now_ - line, std::max(s0, s1) - now_, line, 0.0, v};
+        edge_trees_[item.tree].insert(item.entry);
+    }
+}
+
+void WavefrontPropagation::indexReflex(int v) {
+    for (IndexEntry& item : reflex_entries_[v]) {
+        if (item.tree >= 0) {
+            reflex_trees_[item.tree].erase(item.entry);
+            item.tree = -1;
+        }
+    }
+    if (!vertices_[v].alive || !isReflex(v)) {
+        return;
+    }
+
+    const WavefrontVertex& vertex = vertices_[v];
+    double sx = vertex.velocity.x > 0 ? 1.0 : -1.0;
+    double sy = vertex.velocity.y > 0 ? 1.0 : -1.0;
+    Vec p = positionAt(v, now_);
+    double u = sx * p.x - now_;
+    double w = sy * p.y - now_;
+
+    // d 为已安排分裂时刻对应的直线不变量上界，只有更早到达的边才需要列出该顶点
+    IndexEntry& horizontal = reflex_entries_[v][0];
+    horizontal.tree = treeIndex(sx, sy, true);
+    horizontal.entry = {u - w, u, w, 2.0 * vertex.split_time + w, v};
+    reflex_trees_[horizontal.tree].insert(horizontal.entry);
+
+    IndexEntry& vertical = reflex_entries_[v][1];
+    vertical.tree = treeIndex(sx, sy, false);
+    vertical.entry = {w - u, w, u, 2.0 * vertex.split_time + u, v};
+    reflex_trees_[vertical.tree].insert(vertical.entry);
+}
+
+void WavefrontPropagation::unindex(int v) {
+    indexEdge(v);
+    indexReflex(v);
+}
+
+bool WavefrontPropagation::isValid(const Event& event) const {
+    const WavefrontVertex& v = vertices_[event.vertex];
+    const WavefrontVertex& a = vertices_[event.a];
+    const WavefrontVertex& b = vertices_[event.b];
+    if (!v.alive || !a.alive || !b.alive) {
+        return false;
+    }
+    if (event.type == EdgeCollapse) {
+        return v.version == event.vertex_stamp && a.version == event.a_version;
+    }
+    return v.split_stamp == event.vertex_stamp &&
+           a.version == event.a_version && b.version == event.b_version;
+}
+
+bool WavefrontPropagation::isStaleSplit(const Event& event) const {
+    // 凹顶点仍然有效，只是目标边已变化：需要为该顶点重新寻找分裂目标
+    const WavefrontVertex& v = vertices_[event.vertex];
+    return event.type == Split && v.alive && v.split_stamp == event.vertex_stamp && isReflex(event.vertex);
+}
+
+void WavefrontPropagation::scheduleEdgeCollapse(int v) {
+    const WavefrontVertex& vertex = vertices_[v];
+    int w = vertex.next;
+    const Vec& dir = directions_[vertex.edge];
+
+    double edge_length = dot(positionAt(w, now_) - positionAt(v, now_), dir);
+    double rate = dot(vertices_[w].velocity - vertex.velocity, dir);
+    if (rate > -0.5) {
+        return;
+    }
+
+    Event event;
+    event.time = now_ + std::max(0.0, edge_length) / -rate;
+    event.type = EdgeCollapse;
+    event.vertex = v;
+    event.vertex_stamp = vertex.version;
+    event.a = w;
+    event.a_version = vertices_[w].version;
+    event.b = w;
+    event.b_version = vertices_[w].version;
+    events_.push(event);
+}
+
+bool WavefrontPropagation::splitCandidate(int v, int e, Event& event) const {
+    const WavefrontVertex& reflex = vertices_[v];
+    int e_next = vertices_[e].next;
+    if (e == v || e_next == v || !vertices_[e].alive || vertices_[e].ring != reflex.ring) {
+        return false;
+    }
+
+    const Vec p = positionAt(v, now_);
+    const Vec& vel = reflex.velocity;
+    const Vec& normal = normals_[vertices_[e].edge];
+    const Vec& dir = directions_[vertices_[e].edge];
+    Vec start = positionAt(e, now_);
+
+    // 凹顶点与波前边沿法向的相对接近速度
+    double gap = dot(p - start, normal);
+    double closing = dot(normal, normal) - dot(vel, normal);
+    if (gap < -epsilon_ || closing < 0.5) {
+        return false;
+    }
+
+    double t = now_ + std::max(0.0, gap) / closing;
+    Vec hit = p + vel * (t - now_);
+    double s = dot(hit - positionAt(e, t), dir);
+    double edge_length = dot(positionAt(e_next, t) - positionAt(e, t), dir);
+    if (s < -epsilon_ || s > edge_length + epsilon_) {
+        return false;
+    }
+
+    event.time = t;
+    event.type = Split;
+    event.vertex = v;
+    event.vertex_stamp = reflex.split_stamp;
+    event.a = e;
+    event.a_version = vertices_[e].version;
+    event.b = e_next;
+    event.b_version = vertices_[e_next].version;
+    return true;
+}
+
+void WavefrontPropagation::scheduleSplit(int v) {
+    WavefrontVertex& vertex = vertices_[v];
+    vertex.split_stamp++;
+    vertex.split_time = std::numeric_limits<double>::infinity();
+
+    double sx = vertex.velocity.x > 0 ? 1.0 : -1.0;
+    double sy = vertex.velocity.y > 0 ? 1.0 : -1.0;
+    Vec p = positionAt(v, now_);
+    double u = sx * p.x - now_;
+    double w = sy * p.y - now_;
+    double slack = 4 * epsilon_;
+
+    bool found = false;
+    Event best;
+    Event candidate;
+    auto accept = [&](const DominanceTree::Entry& entry) {
+        if (splitCandidate(v, entry.id, candidate) && (!found || candidate.time < best.time)) {
+            found = true;
+            best = candidate;
+            return true;
+        }
+        return false;
+    };
+
+    // 先在水平边中、再在竖直边中按到达时刻由近到远查找，后者以前者的结果为上界
+    for (bool horizontal : {true, false}) {
+        double along = horizontal ? u : w;
+        double across = horizontal ? w : u;
+        double c_best = found ? 2.0 * best.time + across + slack : std::numeric_limits<double>::infinity();
+        edge_trees_[treeIndex(sx, sy, horizontal)].searchMinC(
+            along - across + slack, along - slack, across + 2.0 * now_ - slack, c_best, accept);
+    }
+
+    if (found) {
+        events_.push(best);
+        vertex.split_time = best.time;
+    }
+    indexReflex(v);
+}
+
+void WavefrontPropagation::scheduleSplitsOnto(int e) {
+    double slack = 4 * epsilon_;
+    std::vector<int> reflex;
+    Event candidate;
+    for (const IndexEntry& item : edge_entries_[e]) {
+        if (item.tree < 0) {
+            continue;
+        }
+        const DominanceTree::Entry& entry = item.entry;
+        reflex.clear();
+        // 已安排在同一直线上分裂的顶点不会因此提前，目标边失效时由旧事件出队后重新搜索
+        reflex_trees_[item.tree].report(entry.a - slack, entry.b + slack, entry.c - 2.0 * now_ + slack,
+                                        entry.c + slack, reflex);
+        for (int v : reflex) {
+            // 本次新建或运动变化的凹顶点已完整搜索过
+            if (touched_marks_[v] == mark_) {
+                continue;
+            }
+            if (splitCandidate(v, e, candidate) && candidate.time < vertices_[v].split_time) {
+                events_.push(candidate);
+                vertices_[v].split_time = candidate.time;
+                indexReflex(v);
+            }
+        }
+    }
+}
+
+void WavefrontPropagation::processEdgeCollapse(const Event& event) {
+    int v = event.vertex;
+    int w = event.a;
+    Vec p = positionAt(v, now_);
+    int node = nodeAt(p, now_);
+
+    int prev = vertices_[v].prev;
+    int next = vertices_[w].next;
+    terminate(v, node);
+    terminate(w, node);
+
+    if (prev == w) {
+        // 只剩两个顶点的环整体消失
+        return;
+    }
+
+    int u = createVertex(p, now_, node, vertices_[w].edge, prev, next);
+    link(prev, u);
+    link(u, next);
+}
+
+void WavefrontPropagation::processSplit(const Event& event) {
+    int r = event.vertex;
+    int a = event.a;
+    int b = event.b;
+    Vec p = positionAt(r, now_);
+    int node = nodeAt(p, now_);
+
+    int rp = vertices_[r].prev;
+    int rn = vertices_[r].next;
+    int split_edge = vertices_[a].edge;
+    int r_edge = vertices_[r].edge;
+    terminate(r, node);
+
+    // 环被分成两部分：rp -> u1 -> b ... 与 a -> u2 -> rn ...
+    int u1 = createVertex(p, now_, node, split_edge, rp, b);
+    int u2 = createVertex(p, now_, node, r_edge, a, rn);
+    link(rp, u1);
+    link(u1, b);
+    link(a, u2);
+    link(u2, rn);
+    relabelSmallerRing(u1, u2);
+}
+
+void WavefrontPropagation::collapseRing(int v) {
+    int w = vertices_[v].next;
+    if (w == v) {
+        terminate(v, nodeAt(positionAt(v, now_), now_));
+        return;
+    }
+
+    // 两条反向重叠的边：两端之间形成屋脊
+    int node_v = nodeAt(positionAt(v, now_), now_);
+    int node_w = nodeAt(positionAt(w, now_), now_);
+    int face_a = vertices_[v].edge;
+    int face_b = vertices_[w].edge;
+    terminate(v, node_v);
+    terminate(w, node_w);
+    addRidge(node_v, node_w, face_a, face_b);
+}
+
+bool WavefrontPropagation::clean() {
+    std::vector<int> queue(touched_.begin(), touched_.end());
+    size_t guard = 0;
+
+    while (!queue.empty()) {
+        if (++guard > 64 * vertices_.size() + 1024) {
+            return false;
+        }
+
+        int v = queue.back();
+        queue.pop_back();
+        if (!vertices_[v].alive) {
+            continue;
+        }
+
+        int w = vertices_[v].next;
+        int u = vertices_[v].prev;
+        if (w == v || vertices_[w].next == v) {
+            collapseRing(v);
+            continue;
+        }
+
+        Vec pv = positionAt(v, now_);
+        Vec pw = positionAt(w, now_);
+        Vec pu = positionAt(u, now_);
+
+        // 零长边：两端合并为一个顶点
+        if (std::abs(pv.x - pw.x) <= epsilon_ && std::abs(pv.y - pw.y) <= epsilon_) {
+            int node = nodeAt(pv, now_);
+            int next = vertices_[w].next;
+            int edge = vertices_[w].edge;
+            terminate(v, node);
+            terminate(w, node);
+            int x = createVertex(pv, now_, node, edge, u, next);
+            link(u, x);
+            link(x, next);
+            queue.push_back(x);
+            queue.push_back(u);
+            queue.push_back(next);
+            continue;
+        }
+
+        int edge_in = vertices_[u].edge;
+        int edge_out = vertices_[v].edge;
+        double turn = dot(directions_[edge_in], directions_[edge_out]);
+
+        if (turn < -0.5) {
+            // 尖刺：两条反向边在同一直线上重叠，重叠部分同时消失形成屋脊
+            double la = length(pv - pu);
+            double lb = length(pw - pv);
+            int tip = nodeAt(pv, now_);
+            terminate(v, tip);
+
+            if (std::abs(la - lb) <= epsilon_) {
+                int node = nodeAt(pu, now_);
+                addRidge(tip, node, edge_in, edge_out);
+                int prev = vertices_[u].prev;
+                int next = vertices_[w].next;
+                int edge = vertices_[w].edge;
+                terminate(u, node);
+                terminate(w, node);
+                if (prev == w) {
+                    continue;
+                }
+                int x = createVertex(pu, now_, node, edge, prev, next);
+                link(prev, x);
+                link(x, next);
+                queue.push_back(x);
+                queue.push_back(prev);
+                queue.push_back(next);
+            } else if (la < lb) {
+                int node = nodeAt(pu, now_);
+                addRidge(tip, node, edge_in, edge_out);
+                int prev = vertices_[u].prev;
+                terminate(u, node);
+                int x = createVertex(pu, now_, node, edge_out, prev, w);
+                link(prev, x);
+                link(x, w);
+                queue.push_back(x);
+                queue.push_back(prev);
+                queue.push_back(w);
+            } else {
+                int node = nodeAt(pw, now_);
+                addRidge(tip, node, edge_in, edge_out);
+                int next = vertices_[w].next;
+                int edge = vertices_[w].edge;
+                terminate(w, node);
+                int x = createVertex(pw, now_, node, edge, u, next);
+                link(u, x);
+                link(x, next);
+                queue.push_back(x);
+                queue.push_back(u);
+                queue.push_back(next);
+            }
+            continue;
+        }
+
+        if (turn > 0.5 && edge_in == edge_out) {
+            // 同一原始边的两段重新相接：中间顶点不再是骨架顶点
+            terminate(v, nodeAt(pv, now_));
+            link(u, w);
+            queue.push_back(u);
+            queue.push_back(w);
+        }
+    }
+
+    return true;
+}
+
+void WavefrontPropagation::reschedule() {
+    ++mark_;
+    std::vector<int> touched;
+    for (int v : touched_) {
+        if (touched_marks_[v] != mark_) {
+            touched_marks_[v] = mark_;
+            touched.push_back(v);
+        }
+    }
+    touched_.clear();
+
+    for (int v : touched) {
+        if (vertices_[v].alive) {
+            updateVelocity(v);
+        }
+    }
+
+    // 端点新建或运动变化的波前边重新加入索引
+    std::vector<int> changed_edges;
+    for (int v : touched) {
+        if (!vertices_[v].alive) {
+            continue;
+        }
+        for (int e : {v, vertices_[v].prev}) {
+            if (edge_marks_[e] != mark_) {
+                edge_marks_[e] = mark_;
+                indexEdge(e);
+                changed_edges.push_back(e);
+            }
+        }
+    }
+
+    for (int v : touched) {
+        if (!vertices_[v].alive) {
+            continue;
+        }
+        scheduleEdgeCollapse(v);
+        scheduleEdgeCollapse(vertices_[v].prev);
+        if (isReflex(v)) {
+            scheduleSplit(v);
+        } else {
+            indexReflex(v);
+        }
+    }
+
+    // 其余凹顶点只与变化的边比较（目标边失效的旧事件在出队时重新搜索）
+    for (int e : changed_edges) {
+        scheduleSplitsOnto(e);
+    }
+}
+
+bool WavefrontPropagation::run() {
+    reschedule();
+
+    size_t guard = 0;
+    // 每个事件只重新安排常数条边与变化边附近的凹顶点，出队次数远低于该上限；超出说明推进陷入循环
+    size_t n = vertices_.size();
+    size_t limit = 64 * n * (static_cast<size_t>(std::log2(static_cast<double>(n) + 1.0)) + 1) + 1024;
+    while (!events_.empty()) {
+        if (++guard > limit) {
+            return false;
+        }
+
+        Event event = events_.top();
+        events_.pop();
+        if (!isValid(event)) {
+            if (isStaleSplit(event)) {
+                scheduleSplit(event.vertex);
+            }
+            continue;
+        }
+
+        now_ = std::max(now_, event.time);
+        if (event.type == EdgeCollapse) {
+            processEdgeCollapse(event);
+        } else {
+            processSplit(event);
+        }
+
+        if (!clean()) {
+            return false;
+        }
+        reschedule();
+    }
+
+    for (const auto& vertex : vertices_) {
+        if (vertex.alive) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * 按“面在左侧”规则，在节点处从反向入射方向顺时针找到的第一条边
+ */
+int pickNextArc(
+    const std::vector<Node>& nodes,
+    const std::vector<Arc>& arcs,
+    const std::vector<int>& candidates,
+    int node,
+    const Vec& incoming
+) {
+    if (candidates.size() == 1) {
+        return candidates.front();
+    }
+
+    double base = std::atan2(-incoming.y, -incoming.x);
+    int best = -1;
+    double best_angle = 0.0;
+    for (int arc : candidates) {
+        int other = arcs[arc].from == node ? arcs[arc].to : arcs[arc].from;
+        Vec d = nodes[other].position - nodes[node].position;
+        double angle = base - std::atan2(d.y, d.x);
+        while (angle <= 0) {
+            angle += 2 * M_PI;
+        }
+        while (angle > 2 * M_PI) {
+            angle -= 2 * M_PI;
+        }
+        if (best < 0 || angle < best_angle) {
+            best = arc;
+            best_angle = angle;
+        }
+    }
+    return best;
+}
+
+/**
+ * 由节点和骨架边构建与 CGAL 相同的半边结构
+ */
+SsPtr buildSkeleton(
+    const std::vector<Node>& nodes,
+    const std::vector<Arc>& arcs,
+    const std::vector<Point>& contour_points,
+    double rotation,
+    double epsilon
+) {
+    typedef Ss::Vertex Vertex;
+    typedef Ss::Halfedge Halfedge;
+    typedef Ss::Face Face;
+    typedef Ss::Vertex_handle Vertex_handle;
+    typedef Ss::Halfedge_handle Halfedge_handle;
+    typedef Ss::Face_handle Face_handle;
+    typedef Ss::Base SsBase;
+    typedef Ss::Vertex::Base VBase;
+    typedef Ss::Halfedge::Base HBase;
+    typedef Ss::Face::Base FBase;
+
+    const int n = static_cast<int>(contour_points.size());
+
+    // 每个面（原始轮廓边）对应的骨架边
+    std::vector<std::vector<int>> node_arcs(nodes.size());
+    for (size_t i = 0; i < arcs.size(); ++i) {
+        node_arcs[arcs[i].from].push_back(static_cast<int>(i));
+        node_arcs[arcs[i].to].push_back(static_cast<int>(i));
+    }
+
+    // 沿每个面逆时针走一圈：轮廓边终点 -> 骨架边 -> 轮廓边起点
+    // 记录每条骨架边在两个面中的走向：+1 表示 from->to，-1 表示 to->from
+    std::vector<std::vector<std::pair<int, int>>> face_cycles(n);
+    std::vector<int> arc_direction_a(arcs.size(), 0);
+    std::vector<int> arc_direction_b(arcs.size(), 0);
+
+    for (int face = 0; face < n; ++face) {
+        int start = face;
+        int current = (face + 1) % n;
+        int previous_arc = -1;
+        Vec incoming = nodes[current].position - nodes[start].position;
+
+        size_t steps = 0;
+        while (current != start) {
+            if (++steps > arcs.size() + 1) {
+                return nullptr;
+            }
+
+            std::vector<int> candidates;
+            for (int arc : node_arcs[current]) {
+                if (arc != previous_arc && (arcs[arc].face_a == face || arcs[arc].face_b == face)) {
+                    candidates.push_back(arc);
+                }
+            }
+            if (candidates.empty()) {
+                return nullptr;
+            }
+
+            int arc = pickNextArc(nodes, arcs, candidates, current, incoming);
+            int direction = arcs[arc].from == current ? 1 : -1;
+            int next = direction > 0 ? arcs[arc].to : arcs[arc].from;
+
+            int& slot = arcs[arc].face_a == face ? arc_direction_a[arc] : arc_direction_b[arc];
+            if (slot != 0) {
+                return nullptr;
+            }
+            slot = direction;
+
+            face_cycles[face].push_back({arc, direction});
+            incoming = nodes[next].position - nodes[current].position;
+            previous_arc = arc;
+            current = next;
+        }
+    }
+
+    // 每条骨架边必须被两侧的面以相反方向各走一次
+    for (size_t i = 0; i < arcs.size(); ++i) {
+        if (arc_direction_a[i] == 0 || arc_direction_a[i] != -arc_direction_b[i]) {
+            return nullptr;
+        }
+    }
+
+    SsPtr skeleton = std::make_shared<Ss>();
+    double cos_r = std::cos(rotation);
+    double sin_r = std::sin(rotation);
+
+    std::vector<Vertex_handle> vertex_handles;
+    vertex_handles.reserve(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (static_cast<int>(i) < n) {
+            vertex_handles.push_back(skeleton->SsBase::vertices_push_back(
+                Vertex(static_cast<int>(i), contour_points[i])));
+        } else {
+            const Vec& p = nodes[i].position;
+            Point point = rotation == 0.0
+                ? Point(p.x, p.y)
+                : Point(p.x * cos_r - p.y * sin_r, p.x * sin_r + p.y * cos_r);
+            vertex_handles.push_back(skeleton->SsBase::vertices_push_back(
+                Vertex(static_cast<int>(i), point, nodes[i].time, false, false)));
+        }
+    }
+
+    int halfedge_id = 0;
+
+    // 轮廓边：face 侧半边方向与多边形一致，对侧为外部边界半边
+    std::vector<Halfedge_handle> contour_halfedges;
+    for (int i = 0; i < n; ++i) {
+        Halfedge_handle h = skeleton->SsBase::edges_push_back(
+            Halfedge(halfedge_id, CGAL::ZERO), Halfedge(halfedge_id + 1, CGAL::ZERO));
+        halfedge_id += 2;
+        h->HBase::set_vertex(vertex_handles[(i + 1) % n]);
+        h->opposite()->HBase::set_vertex(vertex_handles[i]);
+        contour_halfedges.push_back(h);
+    }
+
+    std::vector<Halfedge_handle> arc_halfedges;
+    for (const auto& arc : arcs) {
+        double dt = nodes[arc.to].time - nodes[arc.from].time;
+        CGAL::Sign slope = dt > epsilon ? CGAL::POSITIVE : (dt < -epsilon ? CGAL::NEGATIVE : CGAL::ZERO);
+        CGAL::Sign opposite_slope = slope == CGAL::POSITIVE ? CGAL::NEGATIVE
+                                  : (slope == CGAL::NEGATIVE ? CGAL::POSITIVE : CGAL::ZERO);
+        Halfedge_handle h = skeleton->SsBase::edges_push_back(
+            Halfedge(halfedge_id, slope), Halfedge(halfedge_id + 1, opposite_slope));
+        halfedge_id += 2;
+        h->HBase::set_vertex(vertex_handles[arc.to]);
+        h->opposite()->HBase::set_vertex(vertex_handles[arc.from]);
+        vertex_handles[arc.to]->VBase::set_halfedge(h);
+        vertex_handles[arc.from]->VBase::set_halfedge(h->opposite());
+        arc_halfedges.push_back(h);
+    }
+
+    // 外部边界半边顺时针相连
+    for (int i = 0; i < n; ++i) {
+        Halfedge_handle border = contour_halfedges[i]->opposite();
+        border->HBase::set_face(Face_handle());
+        border->HBase::set_next(contour_halfedges[(i + n - 1) % n]->opposite());
+        border->HBase::set_prev(contour_halfedges[(i + 1) % n]->opposite());
+        vertex_handles[i]->VBase::set_halfedge(border);
+    }
+
+    for (int face = 0; face < n; ++face) {
+        Face_handle face_handle = skeleton->SsBase::faces_push_back(Face(face));
+        face_handle->FBase::set_halfedge(contour_halfedges[face]);
+
+        std::vector<Halfedge_handle> cycle;
+        cycle.push_back(contour_halfedges[face]);
+        for (const auto& [arc, direction] : face_cycles[face]) {
+            cycle.push_back(direction > 0 ? arc_halfedges[arc] : arc_halfedges[arc]->opposite());
+        }
+
+        for (size_t i = 0; i < cycle.size(); ++i) {
+            cycle[i]->HBase::set_face(face_handle);
+            cycle[i]->HBase::set_next(cycle[(i + 1) % cycle.size()]);
+            cycle[i]->HBase::set_prev(cycle[(i + cycle.size() - 1) % cycle.size()]);
+        }
+    }
+
+    return skeleton;
+}
+
+}
+
+bool RectilinearSkeleton::isRectilinear(const Polygon_2& polygon, double& rotation) {
+    rotation = 0.0;
+    size_t n = polygon.size();
+    if (n < 4) {
+        return false;
+    }
+
+    // 严格轴对齐
+    bool axis_aligned = true;
+    for (size_t i = 0; i < n && axis_aligned; ++i) {
+        const Point& p = polygon[i];
+        const Point& q = polygon[(i + 1) % n];
+        bool horizontal = p.y() == q.y() && p.x() != q.x();
+        bool vertical = p.x() == q.x() && p.y() != q.y();
+        axis_aligned = horizontal || vertical;
+    }
+    if (axis_aligned) {
+        return true;
+    }
+
+    // 统一旋转后的正交多边形：以最长边确定旋转角
+    double longest = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double dx = polygon[(i + 1) % n].x() - polygon[i].x();
+        double dy = polygon[(i + 1) % n].y() - polygon[i].y();
+        double len = std::sqrt(dx * dx + dy * dy);
+        if (len == 0.0) {
+            return false;
+        }
+        if (len > longest) {
+            longest = len;
+            rotation = std::fmod(std::atan2(dy, dx) + 2 * M_PI, M_PI / 2);
+        }
+    }
+
+    double cos_r = std::cos(rotation);
+    double sin_r = std::sin(rotation);
+    for (size_t i = 0; i < n; ++i) {
+        double dx = polygon[(i + 1) % n].x() - polygon[i].x();
+        double dy = polygon[(i + 1) % n].y() - polygon[i].y();
+        double rx = dx * cos_r + dy * sin_r;
+        double ry = -dx * sin_r + dy * cos_r;
+        double len = std::sqrt(dx * dx + dy * dy);
+        if (std::min(std::abs(rx), std::abs(ry)) > 1e-9 * len) {
+            rotation = 0.0;
+            return false;
+        }
+    }
+    return true;
+}
+
+SsPtr RectilinearSkeleton::create(const Polygon_2& polygon) {
+    double rotation = 0.0;
+    if (!isRectilinear(polygon, rotation) || !polygon.is_counterclockwise_oriented()) {
+        return nullptr;
+    }
+
+    size_t n = polygon.size();
+    std::vector<Point> contour_points(polygon.vertices_begin(), polygon.vertices_end());
+
+    // 旋转到轴对齐坐标系
+    std::vector<Vec> contour;
+    contour.reserve(n);
+    double cos_r = std::cos(rotation);
+    double sin_r = std::sin(rotation);
+    for (const auto& p : contour_points) {
+        if (rotation == 0.0) {
+            contour.push_back({p.x(), p.y()});
+        } else {
+            contour.push_back({p.x() * cos_r + p.y() * sin_r, -p.x() * sin_r + p.y() * cos_r});
+        }
+    }
+
+    if (rotation != 0.0) {
+        // 旋转带来的舍入误差：同一条水平（竖直）边的端点取平均坐标，使边严格轴对齐
+        std::vector<bool> horizontal(n);
+        for (size_t i = 0; i < n; ++i) {
+            Vec d = contour[(i + 1) % n] - contour[i];
+            horizontal[i] = std::abs(d.y) < std::abs(d.x);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = (i + 1) % n;
+            if (horizontal[i]) {
+                double y = 0.5 * (contour[i].y + contour[j].y);
+                contour[i].y = contour[j].y = y;
+            } else {
+                double x = 0.5 * (contour[i].x + contour[j].x);
+                contour[i].x = contour[j].x = x;
+            }
+        }
+    }
+
+    // 相邻边反向（尖刺）的多边形不是简单多边形
+    for (size_t i = 0; i < n; ++i) {
+        Vec a = contour[(i + 1) % n] - contour[i];
+        Vec b = contour[(i + 2) % n] - contour[(i + 1) % n];
+        if (length(a) == 0.0 || (cross(a, b) == 0.0 && dot(a, b) < 0)) {
+            return nullptr;
+        }
+    }
+
+    WavefrontPropagation propagation(contour);
+    if (!propagation.run()) {
+        return nullptr;
+    }
+
+    double extent = 0.0;
+    for (const auto& p : contour) {
+        extent = std::max(extent, std::max(std::abs(p.x), std::abs(p.y)));
+    }
+    return buildSkeleton(propagation.nodes(), propagation.arcs(), contour_points,
+                         rotation, 1e-9 * std::max(1.0, extent));
+}
+
+bool RectilinearSkeleton::sameTopology(const SsPtr& a, const SsPtr& b, double tolerance) {
+    if (!a || !b) {
+        return false;
+    }
+    if (a->size_of_faces() != b->size_of_faces()) {
+        return false;
+    }
+
+    // 同时发生的多个事件在 CGAL 中可能表示为若干重合顶点和零长边。
+    // 先把两个骨架的顶点一起按容差聚类（网格哈希 + 并查集），之后只比较类编号，排序与比较都是精确的
+    std::unordered_map<const void*, size_t> index;
+    std::vector<std::pair<double, double>> points;
+    std::vector<double> times;
+    for (const SsPtr* skeleton : {&a, &b}) {
+        for (auto vit = (*skeleton)->vertices_begin(); vit != (*skeleton)->vertices_end(); ++vit) {
+            index[&*vit] = points.size();
+            points.push_back({vit->point().x(), vit->point().y()});
+            times.push_back(static_cast<double>(vit->time()));
+        }
+    }
+
+    std::vector<size_t> parent(points.size());
+    for (size_t i = 0; i < parent.size(); ++i) {
+        parent[i] = i;
+    }
+    auto find = [&parent](size_t i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+
+    // 网格边长不小于容差，容差内的顶点一定落在相邻格子中
+    double cell = std::max(tolerance, std::numeric_limits<double>::min());
+    auto key = [](long long cx, long long cy) {
+        return (static_cast<uint64_t>(cx) << 32) ^ static_cast<uint64_t>(cy & 0xffffffffLL);
+    };
+    std::unordered_map<uint64_t, std::vector<size_t>> grid;
+    for (size_t i = 0; i < points.size(); ++i) {
+        double x = points[i].first;
+        double y = points[i].second;
+        long long cx = static_cast<long long>(std::floor(x / cell));
+        long long cy = static_cast<long long>(std::floor(y / cell));
+        for (long long dx = -1; dx <= 1; ++dx) {
+            for (long long dy = -1; dy <= 1; ++dy) {
+                auto it = grid.find(key(cx + dx, cy + dy));
+                if (it == grid.end()) {
+                    continue;
+                }
+                for (size_t j : it->second) {
+                    if (std::abs(x - points[j].first) <= tolerance &&
+                        std::abs(y - points[j].second) <= tolerance) {
+                        parent[find(i)] = find(j);
+                    }
+                }
+            }
+        }
+        grid[key(cx, cy)].push_back(i);
+    }
+
+    // 同一位置的顶点时间必须一致
+    std::vector<double> min_time(points.size(), std::numeric_limits<double>::max());
+    std::vector<double> max_time(points.size(), std::numeric_limits<double>::lowest());
+    for (size_t i = 0; i < points.size(); ++i) {
+        size_t root = find(i);
+        min_time[root] = std::min(min_time[root], times[i]);
+        max_time[root] = std::max(max_time[root], times[i]);
+        if (max_time[root] - min_time[root] > tolerance) {
+            return false;
+        }
+    }
+
+    // 每个屋面从其轮廓边出发的边界环（类编号序列，零长边合并掉），两个骨架的屋面环集合必须相同
+    auto faceCycles = [&index, &find](const SsPtr& skeleton) {
+        std::vector<std::vector<size_t>> cycles;
+        for (auto fit = skeleton->faces_begin(); fit != skeleton->faces_end(); ++fit) {
+            std::vector<size_t> cycle;
+            auto contour = fit->halfedge();
+            auto he = contour;
+            do {
+                size_t id = find(index.at(&*he->vertex()));
+                if (cycle.empty() || cycle.back() != id) {
+                    cycle.push_back(id);
+                }
+                he = he->next();
+            } while (he != contour && cycle.size() <= skeleton->size_of_halfedges());
+            while (cycle.size() > 1 && cycle.back() == cycle.front()) {
+                cycle.pop_back();
+            }
+            cycles.push_back(cycle);
+        }
+        std::sort(cycles.begin(), cycles.end());
+        return cycles;
+    };
+    return faceCycles(a) == faceCycles(b);
+}
+
+}
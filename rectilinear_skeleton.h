@@ -0,0 +1,40 @@
+#pragma once
+
+#include "types.h"
+
+namespace RoofOutline {
+
+/**
+ * 正交多边形直骨架模块
+ * 正交多边形（所有边平行于同一组互相垂直的轴）的波前顶点只沿45°方向运动，
+ * 事件时间和位置都可由坐标的加减与折半直接求得，
+ * 因此可以用事件驱动的方式直接推进波前，无需通用求解器
+ */
+class RectilinearSkeleton {
+public:
+    /**
+     * 判断多边形是否为正交多边形
+     * @param polygon 输入多边形
+     * @param rotation 输出多边形轴相对坐标轴的旋转角（弧度），轴对齐时为0
+     * @return 是否为正交多边形
+     */
+    static bool isRectilinear(const Polygon_2& polygon, double& rotation);
+
+    /**
+     * 计算正交多边形的内部直骨架（输出结构与 CGAL 一致）
+     * @param polygon 逆时针方向的正交多边形
+     * @return 直骨架智能指针；遇到无法处理的情况返回空指针，调用方应回退到 CGAL
+     */
+    static SsPtr create(const Polygon_2& polygon);
+
+    /**
+     * 比较两个直骨架的拓扑与顶点位置是否一致：逐个屋面比较从轮廓边出发的边界环（用于与 CGAL 结果交叉校验，
+     * 容差内的重合顶点视为同一顶点，零长边忽略）
+     * @param a, b 待比较的直骨架
+     * @param tolerance 坐标与时间的容差
+     * @return 是否一致
+     */
+    static bool sameTopology(const SsPtr& a, const SsPtr& b, double tolerance);
+};
+
+}
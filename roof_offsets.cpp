@@ -0,0 +1,227 @@
+#include "roof_offsets.h"
+#include "logger.h"
+#include <cmath>
+#include <algorithm>
+#include <set>
+#include <unordered_map>
+
+namespace RoofOutline {
+
+namespace {
+
+double signedArea(const std::vector<std::pair<double, double>>& ring) {
+    double twice_area = 0.0;
+    for (size_t i = 0; i < ring.size(); ++i) {
+        const auto& p = ring[i];
+        const auto& q = ring[(i + 1) % ring.size()];
+        twice_area += p.first * q.second - q.first * p.second;
+    }
+    return 0.5 * twice_area;
+}
+
+}
+
+double OffsetOutline::length() const {
+    double total = 0.0;
+    for (const auto& ring : rings) {
+        for (size_t i = 0; i < ring.size(); ++i) {
+            const auto& p = ring[i];
+            const auto& q = ring[(i + 1) % ring.size()];
+            total += std::hypot(q.first - p.first, q.second - p.second);
+        }
+    }
+    return total;
+}
+
+double OffsetOutline::area() const {
+    // 外环逆时针、内环顺时针，有向面积之和即为净面积
+    double total = 0.0;
+    for (const auto& ring : rings) {
+        total += signedArea(ring);
+    }
+    return total;
+}
+
+std::vector<RoofOffsets::Ring> RoofOffsets::levelSet(
+    const SsPtr& skeleton,
+    double level,
+    bool keep_below,
+    const Polygon_2* polygon
+) {
+    std::set<std::pair<double, double>> polygon_vertices;
+    if (polygon) {
+        for (auto it = polygon->vertices_begin(); it != polygon->vertices_end(); ++it) {
+            polygon_vertices.insert({it->x(), it->y()});
+        }
+    }
+
+    double extent = 1.0;
+    for (auto vit = skeleton->vertices_begin(); vit != skeleton->vertices_end(); ++vit) {
+        extent = std::max(extent, std::max(std::abs(vit->point().x()), std::abs(vit->point().y())));
+    }
+    double tolerance = 1e-9 * extent;
+
+    // 每条骨架边与等高线至多相交一次，交点按无向边编号，供两侧的面共用
+    std::unordered_map<const void*, size_t> crossing_ids;
+    std::vector<std::pair<double, double>> crossings;
+    auto crossingOf = [&](Ss::Halfedge_const_handle he) -> long {
+        double h0 = he->opposite()->vertex()->time();
+        double h1 = he->vertex()->time();
+        // 恰好等于 level 的顶点按低于处理，保证每个交点只被计一次
+        if ((h0 > level) == (h1 > level)) {
+            return -1;
+        }
+
+        const void* key = &*(he < he->opposite() ? he : he->opposite());
+        auto found = crossing_ids.find(key);
+        if (found != crossing_ids.end()) {
+            return static_cast<long>(found->second);
+        }
+
+        const auto& p = he->opposite()->vertex()->point();
+        const auto& q = he->vertex()->point();
+        double t = (level - h0) / (h1 - h0);
+        crossing_ids[key] = crossings.size();
+        crossings.push_back({p.x() + t * (q.x() - p.x()), p.y() + t * (q.y() - p.y())});
+        return static_cast<long>(crossings.size() - 1);
+    };
+
+    // 面内高度沿轮廓边的左法向线性增加，等高线与轮廓边平行：
+    // 交点按轮廓边方向排序后两两配对，沿轮廓边方向连接时高侧位于左侧
+    std::vector<long> next;
+    size_t unpaired = 0;
+    for (auto fit = skeleton->faces_begin(); fit != skeleton->faces_end(); ++fit) {
+        Ss::Halfedge_const_handle contour;
+        bool has_contour = false;
+        std::vector<std::pair<double, long>> face_crossings;
+
+        auto he = fit->halfedge();
+        auto start = he;
+        do {
+            if (!he->is_bisector() && !has_contour) {
+                contour = he;
+                has_contour = true;
+            }
+            long id = crossingOf(he);
+            if (id >= 0) {
+                face_crossings.push_back({0.0, id});
+            }
+            he = he->next();
+        } while (he != start);
+
+        if (!has_contour || face_crossings.empty()) {
+            continue;
+        }
+        const auto& p = contour->opposite()->vertex()->point();
+        const auto& q = contour->vertex()->point();
+        if (polygon && (!polygon_vertices.count({p.x(), p.y()}) || !polygon_vertices.count({q.x(), q.y()}))) {
+            continue;
+        }
+        if (face_crossings.size() % 2 != 0) {
+            unpaired++;
+            continue;
+        }
+
+        double dx = q.x() - p.x();
+        double dy = q.y() - p.y();
+        for (auto& crossing : face_crossings) {
+            const auto& point = crossings[crossing.second];
+            crossing.first = point.first * dx + point.second * dy;
+        }
+        std::sort(face_crossings.begin(), face_crossings.end());
+
+        next.resize(crossings.size(), -1);
+        for (size_t i = 0; i + 1 < face_crossings.size(); i += 2) {
+            long from = face_crossings[i].second;
+            long to = face_crossings[i + 1].second;
+            if (keep_below) {
+                std::swap(from, to);
+            }
+            next[from] = to;
+        }
+    }
+    next.resize(crossings.size(), -1);
+
+    // 沿 next 首尾相接成环
+    std::vector<Ring> rings;
+    std::vector<bool> visited(crossings.size(), false);
+    size_t broken = 0;
+    for (size_t first = 0; first < crossings.size(); ++first) {
+        if (visited[first] || next[first] < 0) {
+            continue;
+        }
+
+        Ring ring;
+        long current = static_cast<long>(first);
+        while (current >= 0 && !visited[current]) {
+            visited[current] = true;
+            const auto& point = crossings[current];
+            if (ring.empty() || std::abs(point.first - ring.back().first) > tolerance ||
+                std::abs(point.second - ring.back().second) > tolerance) {
+                ring.push_back(point);
+            }
+            current = next[current];
+        }
+        if (current != static_cast<long>(first)) {
+            broken++;
+            continue;
+        }
+
+        while (ring.size() > 1 && std::abs(ring.front().first - ring.back().first) <= tolerance &&
+               std::abs(ring.front().second - ring.back().second) <= tolerance) {
+            ring.pop_back();
+        }
+        if (ring.size() >= 3 && std::abs(signedArea(ring)) > tolerance * extent) {
+            rings.push_back(std::move(ring));
+        }
+    }
+
+    if (unpaired > 0 || broken > 0) {
+        ROOF_LOG_WARNING("offsets", "警告：偏移距离 %g 处有 %zu 个面交点数异常、%zu 个未闭合的环，已忽略",
+                         level, unpaired, broken);
+    }
+    return rings;
+}
+
+std::vector<OffsetOutline> RoofOffsets::interiorOffsets(
+    const SsPtr& skeleton,
+    const std::vector<double>& distances
+) {
+    std::vector<OffsetOutline> outlines;
+    if (!skeleton) {
+        ROOF_LOG_ERROR("offsets", "无法生成偏移轮廓：直骨架为空");
+        return outlines;
+    }
+
+    for (double distance : distances) {
+        OffsetOutline outline;
+        outline.distance = distance;
+        outline.rings = levelSet(skeleton, distance, false, nullptr);
+        ROOF_LOG_DEBUG("offsets", "向内偏移 %g：%zu 个环", distance, outline.rings.size());
+        outlines.push_back(std::move(outline));
+    }
+    return outlines;
+}
+
+std::vector<OffsetOutline> RoofOffsets::exteriorOffsets(
+    const SsPtr& exterior_skeleton,
+    const Polygon_2& polygon,
+    const std::vector<double>& distances
+) {
+    std::vector<OffsetOutline> outlines;
+    if (!exterior_skeleton) {
+        ROOF_LOG_ERROR("offsets", "无法生成挑檐轮廓：外部直骨架为空");
+        return outlines;
+    }
+
+    for (double distance : distances) {
+        OffsetOutline outline;
+        outline.distance = -distance;
+        outline.rings = levelSet(exterior_skeleton, distance, true, &polygon);
+        ROOF_LOG_DEBUG("offsets", "向外偏移 %g：%zu 个环", distance, outline.rings.size());
+        outlines.push_back(std::move(outline));
+    }
+    return outlines;
+}
+
+}
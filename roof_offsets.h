@@ -0,0 +1,79 @@
+#pragma once
+
+#include "types.h"
+#include <vector>
+#include <utility>
+
+namespace RoofOutline {
+
+/**
+ * 某一偏移距离下的偏移轮廓
+ * 环的方向：外环逆时针，内环（洞）顺时针
+ */
+struct OffsetOutline {
+    double distance = 0.0;  // 偏移距离：正值为向内收进（内部直骨架），负值为向外挑出（外部直骨架）
+    std::vector<std::vector<std::pair<double, double>>> rings;
+
+    /**
+     * 所有环的周长之和
+     */
+    double length() const;
+
+    /**
+     * 偏移轮廓围成的面积（内环面积已扣除）
+     */
+    double area() const;
+};
+
+/**
+ * 偏移轮廓模块
+ * 直骨架各顶点的 time() 即其到轮廓的偏移距离，面内高度随位置线性变化，
+ * 因此某一距离的偏移轮廓就是骨架上的等高线：逐面求交后首尾相接成环。
+ * 多个距离复用同一副骨架，不再为每个距离重新计算
+ */
+class RoofOffsets {
+public:
+    /**
+     * 由内部直骨架生成向内偏移轮廓
+     * @param skeleton 内部直骨架
+     * @param distances 偏移距离列表（正值）
+     * @return 每个距离一份偏移轮廓，顺序与 distances 一致
+     */
+    static std::vector<OffsetOutline> interiorOffsets(
+        const SsPtr& skeleton,
+        const std::vector<double>& distances
+    );
+
+    /**
+     * 由外部直骨架生成向外偏移轮廓（挑檐）
+     * @param exterior_skeleton 外部直骨架（见 Geometry::createExteriorSkeleton）
+     * @param polygon 原多边形（用于排除外框对应的面）
+     * @param distances 挑出距离列表（正值，不超过创建外部直骨架时的最大偏移）
+     * @return 每个距离一份偏移轮廓（distance 记为负值），顺序与 distances 一致
+     */
+    static std::vector<OffsetOutline> exteriorOffsets(
+        const SsPtr& exterior_skeleton,
+        const Polygon_2& polygon,
+        const std::vector<double>& distances
+    );
+
+private:
+    typedef std::vector<std::pair<double, double>> Ring;
+
+    /**
+     * 提取骨架在 level 处的等高线
+     * @param skeleton 直骨架
+     * @param level 等高线高度（time）
+     * @param keep_below 为 true 时保留低于 level 的一侧（向外偏移），否则保留高于 level 的一侧
+     * @param polygon 非空时只使用轮廓边两端都是该多边形顶点的面
+     * @return 闭合的环
+     */
+    static std::vector<Ring> levelSet(
+        const SsPtr& skeleton,
+        double level,
+        bool keep_below,
+        const Polygon_2* polygon
+    );
+};
+
+}
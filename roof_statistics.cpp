@@ -0,0 +1,315 @@
+#include "roof_statistics.h"
+#include "geometry.h"
+#include "logger.h"
+#include "csv_format.h"
+#include <fstream>
+#include <cmath>
+#include <algorithm>
+#include <unordered_map>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace RoofOutline {
+
+RoofMetrics RoofStatistics::compute(
+    const SsPtr& skeleton,
+    double roof_angle,
+    const CoordinateTransform& gray_transform,
+    const std::vector<std::pair<double, double>>& gray_vertices
+) {
+    RoofMetrics metrics;
+    metrics.roof_angle = roof_angle;
+    if (!skeleton) {
+        return metrics;
+    }
+
+    double roof_angle_rad = roof_angle * M_PI / 180.0;
+    double slope = std::tan(roof_angle_rad);
+    double area_factor = 1.0 / std::cos(roof_angle_rad);
+
+    // 每个面的内法向（由其轮廓边决定），用于区分斜脊与天沟
+    std::unordered_map<const void*, std::pair<double, double>> inward_normals;
+    inward_normals.reserve(skeleton->size_of_faces());
+    metrics.faces.reserve(skeleton->size_of_faces());
+
+    double gray_sloped_area = 0.0;
+
+    for (auto fit = skeleton->faces_begin(); fit != skeleton->faces_end(); ++fit) {
+        std::vector<std::pair<double, double>> face_svg_vertices;
+        std::pair<double, double> normal = {0.0, 0.0};
+        double twice_area = 0.0;
+
+        auto he = fit->halfedge();
+        auto start = he;
+        do {
+            const auto& p = he->opposite()->vertex()->point();
+            const auto& q = he->vertex()->point();
+            twice_area += p.x() * q.y() - q.x() * p.y();
+
+            if (!he->is_bisector()) {
+                // 轮廓边：面位于其左侧，左法向即内法向
+                double dx = q.x() - p.x();
+                double dy = q.y() - p.y();
+                double length = std::sqrt(dx * dx + dy * dy);
+                metrics.eave_length += length;
+                if (length > 0) {
+                    normal = {-dy / length, dx / length};
+                }
+            }
+
+            face_svg_vertices.push_back({gray_transform.toSVGX(q.x()), gray_transform.toSVGY(q.y())});
+            he = he->next();
+        } while (he != start);
+
+        inward_normals[&*fit] = normal;
+
+        FaceMetrics face;
+        face.plan_area = std::abs(twice_area) * 0.5;
+        face.sloped_area = face.plan_area * area_factor;
+        face.is_gray = Geometry::containsGrayVertex(face_svg_vertices, gray_vertices);
+
+        metrics.plan_area += face.plan_area;
+        metrics.sloped_area += face.sloped_area;
+        if (face.is_gray) {
+            gray_sloped_area += face.sloped_area;
+        }
+        metrics.faces.push_back(face);
+    }
+
+    for (auto hit = skeleton->halfedges_begin(); hit != skeleton->halfedges_end(); ++hit) {
+        if (!hit->is_bisector() || !(hit < hit->opposite())) {
+            continue;
+        }
+
+        auto v1 = hit->opposite()->vertex();
+        auto v2 = hit->vertex();
+        double dx = v2->point().x() - v1->point().x();
+        double dy = v2->point().y() - v1->point().y();
+        double dh = (v2->time() - v1->time()) * slope;
+        double plan_length = std::sqrt(dx * dx + dy * dy);
+        double length = std::sqrt(plan_length * plan_length + dh * dh);
+
+        // 两端等高为水平屋脊
+        if (std::abs(dh) <= 1e-9 * std::max(1.0, plan_length)) {
+            metrics.ridge_length += length;
+            continue;
+        }
+
+        // 当前半边所在面 F 位于其左侧；在 F 一侧若相邻面 G 的平面更高则为凸脊（斜脊），否则为天沟
+        const auto& nf = inward_normals[&*hit->face()];
+        const auto& ng = inward_normals[&*hit->opposite()->face()];
+        double side = (ng.first - nf.first) * -dy + (ng.second - nf.second) * dx;
+        if (side > 0) {
+            metrics.hip_length += length;
+        } else {
+            metrics.valley_length += length;
+        }
+    }
+
+    double max_time = 0.0;
+    for (auto vit = skeleton->vertices_begin(); vit != skeleton->vertices_end(); ++vit) {
+        max_time = std::max(max_time, static_cast<double>(vit->time()));
+    }
+    metrics.max_height = max_time * slope;
+
+    if (metrics.sloped_area > 0) {
+        metrics.gray_area_share = gray_sloped_area / metrics.sloped_area;
+    }
+
+    return metrics;
+}
+
+const std::vector<std::string>& RoofStatisticsTable::columnNames() {
+    static const std::vector<std::string> names = {
+        "roof_angle",
+        "face_count",
+        "plan_area",
+        "sloped_area",
+        "ridge_length",
+        "hip_length",
+        "valley_length",
+        "eave_length",
+        "max_height",
+        "gray_area_share"
+    };
+    return names;
+}
+
+void RoofStatisticsTable::add(
+    const std::string& building_id,
+    const RoofMetrics& metrics,
+    const std::vector<OffsetOutline>& offsets
+) {
+    if (columns_.empty()) {
+        columns_.resize(columnNames().size());
+    }
+
+    uint64_t building_index = building_ids_.size();
+    building_ids_.push_back(building_id);
+
+    // 顺序需与 columnNames() 一致
+    const double values[] = {
+        metrics.roof_angle,
+        static_cast<double>(metrics.faces.size()),
+        metrics.plan_area,
+        metrics.sloped_area,
+        metrics.ridge_length,
+        metrics.hip_length,
+        metrics.valley_length,
+        metrics.eave_length,
+        metrics.max_height,
+        metrics.gray_area_share
+    };
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        columns_[i].push_back(values[i]);
+    }
+
+    for (const auto& face : metrics.faces) {
+        face_building_.push_back(building_index);
+        face_plan_area_.push_back(face.plan_area);
+        face_sloped_area_.push_back(face.sloped_area);
+        face_is_gray_.push_back(face.is_gray ? 1 : 0);
+    }
+
+    uint32_t ring_index = 0;
+    for (const auto& outline : offsets) {
+        for (const auto& ring : outline.rings) {
+            for (const auto& point : ring) {
+                offset_building_.push_back(building_index);
+                offset_distance_.push_back(outline.distance);
+                offset_ring_.push_back(ring_index);
+                offset_x_.push_back(point.first);
+                offset_y_.push_back(point.second);
+            }
+            ring_index++;
+        }
+    }
+}
+
+bool RoofStatisticsTable::writeCSV(const std::string& filename) const {
+    std::ofstream csv(filename);
+    if (!csv) {
+        ROOF_LOG_ERROR("statistics", "无法创建统计 CSV 文件: %s", filename.c_str());
+        return false;
+    }
+    CsvFormat::setFullPrecision(csv);
+
+    csv << "building_id";
+    for (const auto& name : columnNames()) {
+        csv << "," << name;
+    }
+    csv << "\n";
+
+    for (size_t row = 0; row < building_ids_.size(); ++row) {
+        csv << CsvFormat::quote(building_ids_[row]);
+        for (const auto& column : columns_) {
+            csv << "," << column[row];
+        }
+        csv << "\n";
+    }
+
+    csv.close();
+    ROOF_LOG_INFO("statistics", "✓ 统计 CSV 文件已生成: %s", filename.c_str());
+    return true;
+}
+
+bool RoofStatisticsTable::writeFaceCSV(const std::string& filename) const {
+    std::ofstream csv(filename);
+    if (!csv) {
+        ROOF_LOG_ERROR("statistics", "无法创建面统计 CSV 文件: %s", filename.c_str());
+        return false;
+    }
+    CsvFormat::setFullPrecision(csv);
+
+    csv << "building_id,face_index,plan_area,sloped_area,is_gray\n";
+
+    uint64_t face_index = 0;
+    for (size_t i = 0; i < face_building_.size(); ++i) {
+        if (i > 0 && face_building_[i] != face_building_[i - 1]) {
+            face_index = 0;
+        }
+        csv << CsvFormat::quote(building_ids_[face_building_[i]]) << "," << face_index++ << ","
+            << face_plan_area_[i] << "," << face_sloped_area_[i] << ","
+            << static_cast<int>(face_is_gray_[i]) << "\n";
+    }
+
+    csv.close();
+    ROOF_LOG_INFO("statistics", "✓ 面统计 CSV 文件已生成: %s", filename.c_str());
+    return true;
+}
+
+bool RoofStatisticsTable::writeOffsetCSV(const std::string& filename) const {
+    std::ofstream csv(filename);
+    if (!csv) {
+        ROOF_LOG_ERROR("statistics", "无法创建偏移轮廓 CSV 文件: %s", filename.c_str());
+        return false;
+    }
+    CsvFormat::setFullPrecision(csv);
+
+    csv << "building_id,distance,ring_index,vertex_index,x,y\n";
+
+    uint64_t vertex_index = 0;
+    for (size_t i = 0; i < offset_building_.size(); ++i) {
+        if (i > 0 && (offset_building_[i] != offset_building_[i - 1] || offset_ring_[i] != offset_ring_[i - 1])) {
+            vertex_index = 0;
+        }
+        csv << CsvFormat::quote(building_ids_[offset_building_[i]]) << "," << offset_distance_[i] << ","
+            << offset_ring_[i] << "," << vertex_index++ << ","
+            << offset_x_[i] << "," << offset_y_[i] << "\n";
+    }
+
+    csv.close();
+    ROOF_LOG_INFO("statistics", "✓ 偏移轮廓 CSV 文件已生成: %s", filename.c_str());
+    return true;
+}
+
+bool RoofStatisticsTable::writeBinary(const std::string& filename) const {
+    std::ofstream bin(filename, std::ios::binary);
+    if (!bin) {
+        ROOF_LOG_ERROR("statistics", "无法创建统计二进制文件: %s", filename.c_str());
+        return false;
+    }
+
+    auto write_raw = [&bin](const void* data, size_t bytes) {
+        bin.write(static_cast<const char*>(data), bytes);
+    };
+
+    const uint32_t version = 2;
+    const uint64_t building_count = building_ids_.size();
+    const uint64_t face_count = face_building_.size();
+    const uint64_t offset_count = offset_building_.size();
+    write_raw("ROOFSTAT", 8);
+    write_raw(&version, sizeof(version));
+    write_raw(&building_count, sizeof(building_count));
+    write_raw(&face_count, sizeof(face_count));
+    write_raw(&offset_count, sizeof(offset_count));
+
+    for (const auto& id : building_ids_) {
+        uint32_t length = static_cast<uint32_t>(id.size());
+        write_raw(&length, sizeof(length));
+        write_raw(id.data(), id.size());
+    }
+
+    for (const auto& column : columns_) {
+        write_raw(column.data(), column.size() * sizeof(double));
+    }
+
+    write_raw(face_building_.data(), face_building_.size() * sizeof(uint64_t));
+    write_raw(face_plan_area_.data(), face_plan_area_.size() * sizeof(double));
+    write_raw(face_sloped_area_.data(), face_sloped_area_.size() * sizeof(double));
+    write_raw(face_is_gray_.data(), face_is_gray_.size());
+
+    write_raw(offset_building_.data(), offset_building_.size() * sizeof(uint64_t));
+    write_raw(offset_distance_.data(), offset_distance_.size() * sizeof(double));
+    write_raw(offset_ring_.data(), offset_ring_.size() * sizeof(uint32_t));
+    write_raw(offset_x_.data(), offset_x_.size() * sizeof(double));
+    write_raw(offset_y_.data(), offset_y_.size() * sizeof(double));
+
+    bin.close();
+    ROOF_LOG_INFO("statistics", "✓ 统计二进制文件已生成: %s", filename.c_str());
+    return true;
+}
+
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "types.h"
+#include "coordinate_transform.h"
+#include "roof_offsets.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace RoofOutline {
+
+/**
+ * 单个屋面的统计量
+ */
+struct FaceMetrics {
+    double plan_area = 0.0;     // 水平投影面积
+    double sloped_area = 0.0;   // 实际坡面面积
+    bool is_gray = false;       // 是否为灰色面
+};
+
+/**
+ * 单栋建筑的屋顶统计量（长度均为三维真实长度）
+ */
+struct RoofMetrics {
+    double roof_angle = 0.0;        // 屋顶倾斜角度（度）
+    double plan_area = 0.0;         // 水平投影总面积
+    double sloped_area = 0.0;       // 坡面总面积
+    double ridge_length = 0.0;      // 屋脊线（水平骨架边）总长
+    double hip_length = 0.0;        // 斜脊（凸角骨架边）总长
+    double valley_length = 0.0;     // 天沟（凹角骨架边）总长
+    double eave_length = 0.0;       // 檐口（外轮廓）总长
+    double max_height = 0.0;        // 最大高度（由骨架 time() 换算）
+    double gray_area_share = 0.0;   // 灰色面面积占比
+    std::vector<FaceMetrics> faces;
+};
+
+/**
+ * 屋顶统计模块
+ * 一次遍历直骨架计算面积、屋脊/斜脊/天沟/檐口长度等，不涉及任何渲染
+ */
+class RoofStatistics {
+public:
+    /**
+     * 计算屋顶统计量
+     * @param skeleton 直骨架
+     * @param roof_angle 屋顶倾斜角度（度）
+     * @param gray_transform 灰色顶点所在的坐标转换器（与SVG俯视图一致）
+     * @param gray_vertices 需要标记为灰色的特殊顶点（SVG坐标）
+     * @return 统计结果
+     */
+    static RoofMetrics compute(
+        const SsPtr& skeleton,
+        double roof_angle,
+        const CoordinateTransform& gray_transform,
+        const std::vector<std::pair<double, double>>& gray_vertices
+    );
+};
+
+/**
+ * 批量统计结果表（按列存储）
+ * 建筑级统计、面级统计与偏移轮廓顶点分别成表，可输出为CSV或二进制列式文件
+ */
+class RoofStatisticsTable {
+public:
+    /**
+     * 追加一栋建筑的统计结果
+     * @param building_id 建筑标识
+     * @param metrics 统计结果
+     * @param offsets 偏移轮廓（向内收进线与挑檐）
+     */
+    void add(
+        const std::string& building_id,
+        const RoofMetrics& metrics,
+        const std::vector<OffsetOutline>& offsets = std::vector<OffsetOutline>()
+    );
+
+    /**
+     * 已追加的建筑数
+     */
+    size_t size() const { return building_ids_.size(); }
+
+    /**
+     * 输出建筑级统计CSV
+     * @param filename 输出文件名
+     * @return 是否成功
+     */
+    bool writeCSV(const std::string& filename) const;
+
+    /**
+     * 输出面级统计CSV
+     * @param filename 输出文件名
+     * @return 是否成功
+     */
+    bool writeFaceCSV(const std::string& filename) const;
+
+    /**
+     * 输出偏移轮廓顶点CSV（每行一个顶点，环内按顶点顺序排列）
+     * @param filename 输出文件名
+     * @return 是否成功
+     */
+    bool writeOffsetCSV(const std::string& filename) const;
+
+    /**
+     * 输出二进制列式文件（小端序）：
+     *   "ROOFSTAT" | uint32 版本(2) | uint64 建筑数 | uint64 面数 | uint64 偏移轮廓顶点数
+     *   建筑标识：每个为 uint32 长度 + UTF-8 字节
+     *   建筑列：按列名顺序，每列为连续的 double 数组
+     *   面列：uint64 建筑下标数组，随后 plan_area、sloped_area 两个 double 数组，is_gray 的 uint8 数组
+     *   偏移轮廓列：uint64 建筑下标数组，distance 的 double 数组（负值为挑檐），
+     *     uint32 环序号数组（建筑内从0编号），随后 x、y 两个 double 数组
+     * @param filename 输出文件名
+     * @return 是否成功
+     */
+    bool writeBinary(const std::string& filename) const;
+
+    /**
+     * 建筑级数值列的列名（与二进制文件中的列顺序一致）
+     */
+    static const std::vector<std::string>& columnNames();
+
+private:
+    std::vector<std::string> building_ids_;
+    std::vector<std::vector<double>> columns_;
+
+    std::vector<uint64_t> face_building_;
+    std::vector<double> face_plan_area_;
+    std::vector<double> face_sloped_area_;
+    std::vector<uint8_t> face_is_gray_;
+
+    std::vector<uint64_t> offset_building_;
+    std::vector<double> offset_distance_;
+    std::vector<uint32_t> offset_ring_;
+    std::vector<double> offset_x_;
+    std::vector<double> offset_y_;
+};
+
+}
@@ -1,4 +1,5 @@
 #include "roof_unfold.h"
+#include "geometry.h"
 #include <cmath>
 #include <algorithm>
 
@@ -56,25 +57,6 @@ std::pair<double, double> RoofUnfold::unfoldVertex(double x, double y) const {
     return {x, y};
 }
 
-bool RoofUnfold::containsGrayVertex(
-    const std::vector<std::pair<double, double>>& face_svg_vertices,
-    const std::vector<std::pair<double, double>>& gray_vertices
-) {
-    int match_count = 0;
-    double epsilon = 0.5;
-    
-    for (const auto& fv : face_svg_vertices) {
-        for (const auto& gv : gray_vertices) {
-            if (std::abs(fv.first - gv.first) < epsilon && 
-                std::abs(fv.second - gv.second) < epsilon) {
-                match_count++;
-                break;
-            }
-        }
-    }
-    return match_count >= 3; // 至少包含3个指定顶点才填充灰色
-}
-
 std::vector<std::pair<std::vector<std::pair<double, double>>, bool>> 
 RoofUnfold::computeUnfoldedFaces(
     const CoordinateTransform& ridge_transform,
@@ -143,7 +125,7 @@ RoofUnfold::computeUnfoldedFaces(
                 ridge_transform.toSVGY(v.second)
             });
         }
-        bool is_gray = containsGrayVertex(svg_verts_for_check, gray_vertices);
+        bool is_gray = Geometry::containsGrayVertex(svg_verts_for_check, gray_vertices);
 
         unfolded_faces.push_back({unfolded_verts, is_gray});
     }
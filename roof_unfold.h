@@ -70,14 +70,6 @@ private:
      * 展开单个顶点
      */
     std::pair<double, double> unfoldVertex(double x, double y) const;
-
-    /**
-     * 检查面顶点是否包含灰色顶点
-     */
-    static bool containsGrayVertex(
-        const std::vector<std::pair<double, double>>& face_svg_vertices,
-        const std::vector<std::pair<double, double>>& gray_vertices
-    );
 };
 
 } 
@@ -0,0 +1,122 @@
+#include "shared_result_benchmark.h"
+#include "shared_result_sink.h"
+#include "shared_result_reader.h"
+#include "logger.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+namespace RoofOutline {
+
+uint64_t SharedResultBenchmark::checksum(const void* data, size_t bytes, uint64_t seed) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < bytes; ++i) {
+        seed = (seed ^ p[i]) * 1099511628211ull;
+    }
+    return seed;
+}
+
+bool SharedResultBenchmark::run(
+    const std::string& building_id,
+    const SsPtr& skeleton,
+    const RoofMetrics& metrics,
+    const std::vector<std::pair<std::vector<std::pair<double, double>>, bool>>& unfolded_faces,
+    const std::string& ridge_svg,
+    const std::string& unfolded_svg,
+    int iterations
+) {
+    if (iterations <= 0) {
+        return false;
+    }
+    auto elapsed_ms = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    // 文件方式：写出两份SVG后立即读回
+    const std::string ridge_file = "benchmark_roof_ridges.svg";
+    const std::string unfolded_file = "benchmark_roof_unfolded.svg";
+    uint64_t file_checksum = 0;
+    size_t file_bytes = 0;
+    auto write_then_read = [&](const std::string& filename, const std::string& svg) {
+        std::ofstream(filename, std::ios::binary).write(svg.data(), svg.size());
+        std::ifstream input(filename, std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        file_checksum = checksum(content.data(), content.size(), file_checksum);
+        file_bytes += content.size();
+    };
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        write_then_read(ridge_file, ridge_svg);
+        write_then_read(unfolded_file, unfolded_svg);
+    }
+    double file_ms = elapsed_ms(start);
+    std::remove(ridge_file.c_str());
+    std::remove(unfolded_file.c_str());
+
+    // 共享内存方式：消费者线程经由同名共享内存原地读取网格、展开面与SVG。
+    // 名称带上进程号：POSIX 上创建时会删除同名的旧对象，不能影响其他进程正在使用的缓冲区
+    const std::string shm_name = "benchmark_" + std::to_string(SharedProcess::currentId());
+    SharedResultSink sink;
+    if (!sink.open(shm_name, 8u << 20)) {
+        return false;
+    }
+    SharedResultReader reader;
+    if (!reader.open(shm_name)) {
+        return false;
+    }
+
+    uint64_t shm_checksum = 0;
+    size_t shm_bytes = 0;
+    int received = 0;
+    start = std::chrono::steady_clock::now();
+    std::thread consumer([&]() {
+        SharedResultView view;
+        while (received < iterations && reader.next(view, 5000)) {
+            shm_checksum = checksum(view.ridge_svg, view.ridge_svg_bytes, shm_checksum);
+            shm_checksum = checksum(view.unfolded_svg, view.unfolded_svg_bytes, shm_checksum);
+            shm_bytes += view.ridge_svg_bytes + view.unfolded_svg_bytes;
+            // 网格与展开面同样原地读取
+            double sum = 0.0;
+            for (uint32_t k = 0; k < 3 * view.vertex_count; ++k) {
+                sum += view.vertices[k];
+            }
+            for (uint32_t k = 0; k < 2 * view.unfolded_offsets[view.unfolded_face_count]; ++k) {
+                sum += view.unfolded_points[k];
+            }
+            shm_checksum += static_cast<uint64_t>(sum);
+            reader.release();
+            received++;
+        }
+    });
+    for (int i = 0; i < iterations; ++i) {
+        if (!sink.publish(building_id, skeleton, metrics, unfolded_faces, ridge_svg, unfolded_svg, 5000)) {
+            break;
+        }
+    }
+    consumer.join();
+    double shm_ms = elapsed_ms(start);
+    reader.close();
+    sink.close();
+
+    if (received != iterations || file_bytes != shm_bytes) {
+        ROOF_LOG_ERROR("benchmark", "共享内存方式只收到 %d / %d 条结果", received, iterations);
+        return false;
+    }
+
+    auto report = [iterations](const char* method, double ms, size_t bytes) {
+        double seconds = ms / 1000.0;
+        ROOF_LOG_INFO("benchmark", "%s：%d 条结果，%.2fms，%.0f 条/秒，SVG %.1f MB/s", method, iterations, ms,
+                      iterations / seconds, bytes / seconds / (1024.0 * 1024.0));
+    };
+    report("文件输出并读回", file_ms, file_bytes);
+    report("共享内存环形缓冲区", shm_ms, shm_bytes);
+    ROOF_LOG_INFO("benchmark", "共享内存方式耗时为文件方式的 %.1f%%", 100.0 * shm_ms / file_ms);
+    ROOF_LOG_DEBUG("benchmark", "校验和：文件 %llx，共享内存 %llx",
+                   static_cast<unsigned long long>(file_checksum), static_cast<unsigned long long>(shm_checksum));
+    return true;
+}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "types.h"
+#include "roof_statistics.h"
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace RoofOutline {
+
+/**
+ * 结果交付吞吐量对比
+ * 文件方式：每栋写出俯视图与展开图两份SVG，再由消费者从磁盘读回（现有的交付方式）；
+ * 共享内存方式：发布到 SharedResultSink，由消费者线程以 SharedResultReader 打开同名共享内存原地读取。
+ * 两种方式的消费者都完整扫描收到的字节，结果通过日志输出
+ */
+class SharedResultBenchmark {
+public:
+    /**
+     * 执行对比测试（以同一栋建筑的结果重复 iterations 次）
+     * @param building_id 建筑标识
+     * @param skeleton 直骨架
+     * @param metrics 统计结果
+     * @param unfolded_faces 展开后的面信息
+     * @param ridge_svg 屋脊线俯视图SVG
+     * @param unfolded_svg 屋顶展开图SVG
+     * @param iterations 重复次数
+     * @return 是否成功
+     */
+    static bool run(
+        const std::string& building_id,
+        const SsPtr& skeleton,
+        const RoofMetrics& metrics,
+        const std::vector<std::pair<std::vector<std::pair<double, double>>, bool>>& unfolded_faces,
+        const std::string& ridge_svg,
+        const std::string& unfolded_svg,
+        int iterations
+    );
+
+private:
+    /**
+     * 扫描字节并累加到校验和（避免消费者的读取被优化掉）
+     */
+    static uint64_t checksum(const void* data, size_t bytes, uint64_t seed);
+};
+
+}
@@ -0,0 +1,196 @@
+#include "shared_result_reader.h"
+#include "logger.h"
+#include <chrono>
+#include <cstring>
+
+namespace RoofOutline {
+
+SharedResultReader::~SharedResultReader() {
+    close();
+}
+
+bool SharedResultReader::open(const std::string& name) {
+    close();
+    if (!region_.open(name)) {
+        return false;
+    }
+
+    auto* header = reinterpret_cast<SharedRingHeader*>(region_.data());
+    // 生产者最后写入版本号：为 0 说明头部尚未写完，与尚未创建同样由调用方重试
+    if (region_.size() >= sizeof(SharedRingHeader) && header->version.load(std::memory_order_acquire) == 0) {
+        ROOF_LOG_DEBUG("shm", "共享内存 %s 尚未创建完成", name.c_str());
+        region_.close();
+        return false;
+    }
+    if (region_.size() < sizeof(SharedRingHeader) ||
+        std::memcmp(header->magic, kSharedRingMagic, sizeof(header->magic)) != 0 ||
+        header->version.load(std::memory_order_relaxed) != kSharedRingVersion ||
+        header->header_bytes != sizeof(SharedRingHeader) ||
+        header->capacity == 0 || (header->capacity & (header->capacity - 1)) != 0 ||
+        region_.size() < header->header_bytes + header->capacity) {
+        ROOF_LOG_ERROR("shm", "共享内存 %s 不是有效的结果缓冲区（或版本不兼容）", name.c_str());
+        region_.close();
+        return false;
+    }
+    if (header->producer_closed.load()) {
+        ROOF_LOG_DEBUG("shm", "共享内存 %s 的生产者已关闭", name.c_str());
+        region_.close();
+        return false;
+    }
+
+    // 登记为消费者；已登记的进程若已退出（异常终止来不及断开），由本进程接管
+    uint32_t self = SharedProcess::currentId();
+    uint32_t previous = header->consumer_pid.load();
+    do {
+        if (previous != 0 && SharedProcess::isAlive(previous)) {
+            ROOF_LOG_ERROR("shm", "共享内存 %s 已有消费者连接（进程 %u）", name.c_str(), previous);
+            region_.close();
+            return false;
+        }
+    } while (!header->consumer_pid.compare_exchange_weak(previous, self));
+    if (previous != 0) {
+        ROOF_LOG_WARNING("shm", "警告：共享内存 %s 的上一个消费者（进程 %u）已退出，由本进程接管", name.c_str(), previous);
+    }
+
+    header_ = header;
+    ring_data_ = region_.data() + header->header_bytes;
+    capacity_ = header->capacity;
+    pending_ = 0;
+
+    if (!data_signal_.open(name + "_data", &header_->data_seq) ||
+        !space_signal_.open(name + "_space", &header_->space_seq)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SharedResultReader::close() {
+    if (header_) {
+        release();
+        uint32_t self = SharedProcess::currentId();
+        header_->consumer_pid.compare_exchange_strong(self, 0);
+        // 生产者可能正等待空间，唤醒它以便重新检查是否还有消费者
+        space_signal_.notify();
+    }
+    data_signal_.close();
+    space_signal_.close();
+    region_.close();
+    header_ = nullptr;
+    ring_data_ = nullptr;
+    capacity_ = 0;
+    pending_ = 0;
+    corrupted_ = false;
+}
+
+bool SharedResultReader::producerClosed() const {
+    return header_ && header_->producer_closed.load() != 0;
+}
+
+uint64_t SharedResultReader::published() const {
+    return header_ ? header_->published.load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t SharedResultReader::dropped() const {
+    return header_ ? header_->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+void SharedResultReader::advance(uint64_t bytes) {
+    header_->read_pos.store(header_->read_pos.load(std::memory_order_relaxed) + bytes);
+    header_->space_seq.fetch_add(1);
+    if (header_->producer_waiting.exchange(0)) {
+        space_signal_.notify();
+    }
+}
+
+void SharedResultReader::release() {
+    if (header_ && pending_ > 0) {
+        advance(pending_);
+        pending_ = 0;
+    }
+}
+
+bool SharedResultReader::next(SharedResultView& view, int timeout_ms) {
+    if (!header_ || corrupted_) {
+        return false;
+    }
+    release();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+        uint64_t read = header_->read_pos.load(std::memory_order_relaxed);
+        uint64_t write = header_->write_pos.load(std::memory_order_acquire);
+
+        if (write != read) {
+            uint64_t offset = read & (capacity_ - 1);
+            const uint8_t* data = ring_data_ + offset;
+            SharedRecordHeader record;
+            std::memcpy(&record, data, sizeof(record));
+            if (record.size < sizeof(SharedRecordHeader) || record.size % 8 != 0 ||
+                record.size > capacity_ - offset || record.size > write - read) {
+                ROOF_LOG_ERROR("shm", "共享内存结果缓冲区数据损坏（位置 %llu）", static_cast<unsigned long long>(read));
+                corrupted_ = true;
+                return false;
+            }
+            if (record.type != kSharedRecordBuilding) {
+                advance(record.size);
+                continue;
+            }
+
+            SharedRecordLayout layout = SharedRecordLayout::compute(record);
+            if (layout.size != record.size) {
+                ROOF_LOG_ERROR("shm", "共享内存结果记录 %llu 长度不一致", static_cast<unsigned long long>(record.sequence));
+                corrupted_ = true;
+                return false;
+            }
+
+            view.sequence = record.sequence;
+            view.roof_angle = record.roof_angle;
+            view.building_id = reinterpret_cast<const char*>(data + layout.building_id);
+            view.building_id_bytes = record.building_id_bytes;
+            view.vertices = reinterpret_cast<const double*>(data + layout.vertices);
+            view.vertex_count = record.vertex_count;
+            view.face_offsets = reinterpret_cast<const uint32_t*>(data + layout.face_offsets);
+            view.face_indices = reinterpret_cast<const uint32_t*>(data + layout.face_indices);
+            view.face_gray = data + layout.face_gray;
+            view.face_count = record.face_count;
+            view.unfolded_offsets = reinterpret_cast<const uint32_t*>(data + layout.unfolded_offsets);
+            view.unfolded_points = reinterpret_cast<const double*>(data + layout.unfolded_points);
+            view.unfolded_gray = data + layout.unfolded_gray;
+            view.unfolded_face_count = record.unfolded_face_count;
+            view.ridge_svg = reinterpret_cast<const char*>(data + layout.ridge_svg);
+            view.ridge_svg_bytes = record.ridge_svg_bytes;
+            view.unfolded_svg = reinterpret_cast<const char*>(data + layout.unfolded_svg);
+            view.unfolded_svg_bytes = record.unfolded_svg_bytes;
+            pending_ = record.size;
+            return true;
+        }
+
+        // 关闭标记在最后一次发布之后写入：看到标记后再确认一次确实没有剩余记录
+        if (header_->producer_closed.load()) {
+            if (header_->write_pos.load() != read) {
+                continue;
+            }
+            return false;
+        }
+
+        int remaining = -1;
+        if (timeout_ms >= 0) {
+            remaining = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count());
+            if (remaining <= 0) {
+                return false;
+            }
+        }
+
+        // 先声明等待再复查写位置，生产者发布后一定能看到该标记并发出唤醒
+        uint32_t seq = header_->data_seq.load(std::memory_order_acquire);
+        header_->consumer_waiting.store(1);
+        if (header_->write_pos.load() != read) {
+            continue;
+        }
+        data_signal_.wait(seq, remaining);
+    }
+}
+
+}
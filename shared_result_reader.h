@@ -0,0 +1,110 @@
+#pragma once
+
+#include "shared_ring.h"
+#include <cstdint>
+#include <string>
+
+namespace RoofOutline {
+
+/**
+ * 共享内存中一栋建筑结果的只读视图
+ * 所有指针直接指向共享内存，在调用 SharedResultReader::release() 或下一次 next() 之前有效
+ */
+struct SharedResultView {
+    uint64_t sequence = 0;
+    double roof_angle = 0.0;
+
+    const char* building_id = nullptr;          // 不以 0 结尾，长度为 building_id_bytes
+    uint32_t building_id_bytes = 0;
+
+    const double* vertices = nullptr;           // x, y, z 依次排列
+    uint32_t vertex_count = 0;
+
+    const uint32_t* face_offsets = nullptr;     // 第 i 个屋面的顶点下标为 face_indices[face_offsets[i] .. face_offsets[i + 1])
+    const uint32_t* face_indices = nullptr;
+    const uint8_t* face_gray = nullptr;
+    uint32_t face_count = 0;
+
+    const uint32_t* unfolded_offsets = nullptr; // 第 i 个展开面的顶点为 unfolded_points 中 [offsets[i], offsets[i + 1]) 个点
+    const double* unfolded_points = nullptr;    // x, y 依次排列
+    const uint8_t* unfolded_gray = nullptr;
+    uint32_t unfolded_face_count = 0;
+
+    const char* ridge_svg = nullptr;
+    uint32_t ridge_svg_bytes = 0;
+    const char* unfolded_svg = nullptr;
+    uint32_t unfolded_svg_bytes = 0;
+};
+
+/**
+ * 共享内存结果读取模块（消费者）
+ * 不依赖 CGAL，可单独与 shared_ring.cpp、logger.cpp 一起编译进其他进程；同一缓冲区同一时间只允许一个消费者
+ */
+class SharedResultReader {
+public:
+    SharedResultReader() = default;
+    ~SharedResultReader();
+
+    /**
+     * 连接生产者创建的共享内存；已有消费者且其进程仍在运行时失败，已退出的消费者由本进程接管
+     * @param name 共享内存名称
+     * @return 是否成功
+     */
+    bool open(const std::string& name);
+
+    /**
+     * 断开连接（未释放的记录视为已读）
+     */
+    void close();
+
+    bool isOpen() const { return header_ != nullptr; }
+
+    /**
+     * 取下一条结果（原地读取，不复制）；上一条尚未释放时先释放
+     * @param view 输出视图
+     * @param timeout_ms 没有新结果时最多等待的毫秒数（< 0 为一直等待）
+     * @return 是否取到结果（超时、数据损坏或生产者已关闭且没有剩余记录时为 false）
+     */
+    bool next(SharedResultView& view, int timeout_ms);
+
+    /**
+     * 释放当前结果，其占用的空间可被生产者复用
+     */
+    void release();
+
+    /**
+     * 生产者是否已关闭（此后 next() 读完剩余记录即返回 false，应断开后重新连接）
+     */
+    bool producerClosed() const;
+
+    /**
+     * 是否检测到数据损坏（此后 next() 总是返回 false，应断开）；用于区分 next() 的超时与错误
+     */
+    bool corrupted() const { return corrupted_; }
+
+    /**
+     * 生产者已发布 / 已丢弃的记录数
+     */
+    uint64_t published() const;
+    uint64_t dropped() const;
+
+private:
+    SharedResultReader(const SharedResultReader&) = delete;
+    SharedResultReader& operator=(const SharedResultReader&) = delete;
+
+    /**
+     * 把读位置推进 bytes 字节，并在生产者等待空间时唤醒它
+     */
+    void advance(uint64_t bytes);
+
+    SharedMemoryRegion region_;
+    SharedSignal data_signal_;
+    SharedSignal space_signal_;
+    SharedRingHeader* header_ = nullptr;
+    const uint8_t* ring_data_ = nullptr;
+    uint64_t capacity_ = 0;
+    uint64_t pending_ = 0;      // 当前未释放记录的字节数
+    bool corrupted_ = false;    // 已检测到数据损坏
+};
+
+}
@@ -0,0 +1,279 @@
+#include "shared_result_sink.h"
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <unordered_map>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace RoofOutline {
+
+namespace {
+
+// 等待空间时复查消费者是否存活的间隔（毫秒）
+const int kConsumerCheckMs = 100;
+
+}
+
+SharedResultSink::~SharedResultSink() {
+    close();
+}
+
+bool SharedResultSink::open(const std::string& name, size_t capacity) {
+    close();
+
+    uint64_t rounded = 4096;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    if (!region_.create(name, sizeof(SharedRingHeader) + rounded)) {
+        return false;
+    }
+
+    // 名称此时已对消费者可见：version 保持为 0，直到其余字段和通知对象都准备好
+    header_ = new (region_.data()) SharedRingHeader();
+    std::memcpy(header_->magic, kSharedRingMagic, sizeof(header_->magic));
+    header_->header_bytes = sizeof(SharedRingHeader);
+    header_->capacity = rounded;
+    ring_data_ = region_.data() + sizeof(SharedRingHeader);
+    capacity_ = rounded;
+    sequence_ = 0;
+
+    if (!data_signal_.open(name + "_data", &header_->data_seq) ||
+        !space_signal_.open(name + "_space", &header_->space_seq)) {
+        close();
+        return false;
+    }
+    header_->version.store(kSharedRingVersion, std::memory_order_release);
+
+    ROOF_LOG_INFO("shm", "共享内存结果缓冲区已创建: %s（%llu 字节）", name.c_str(),
+                  static_cast<unsigned long long>(rounded));
+    return true;
+}
+
+void SharedResultSink::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (header_) {
+        header_->producer_closed.store(1);
+        header_->data_seq.fetch_add(1);
+        data_signal_.notify();
+    }
+    data_signal_.close();
+    space_signal_.close();
+    region_.close();
+    header_ = nullptr;
+    ring_data_ = nullptr;
+    capacity_ = 0;
+}
+
+bool SharedResultSink::drain(int timeout_ms, int connect_timeout_ms) {
+    if (!header_) {
+        return true;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto connect_deadline = start + std::chrono::milliseconds(connect_timeout_ms);
+    auto deadline = connect_deadline + std::chrono::milliseconds(timeout_ms);
+    uint64_t write = header_->write_pos.load(std::memory_order_relaxed);
+    uint64_t read = header_->read_pos.load(std::memory_order_acquire);
+    if (read != write && (consumerAlive() || connect_timeout_ms > 0)) {
+        ROOF_LOG_INFO("shm", "等待消费者读取剩余的 %llu 字节结果...", static_cast<unsigned long long>(write - read));
+    }
+    while (read != write) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= connect_deadline && !consumerAlive()) {
+            ROOF_LOG_INFO("shm", "没有消费者连接，%llu 字节结果未被读取",
+                          static_cast<unsigned long long>(write - read));
+            return false;
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+        if (remaining <= 0) {
+            ROOF_LOG_WARNING("shm", "警告：消费者未在 %dms 内读完结果", timeout_ms);
+            return false;
+        }
+
+        uint32_t seq = header_->space_seq.load(std::memory_order_acquire);
+        header_->producer_waiting.store(1);
+        read = header_->read_pos.load();
+        if (read == write) {
+            break;
+        }
+        // 尚无消费者或消费者异常退出时不会有唤醒，按短间隔重新检查
+        space_signal_.wait(seq, std::min(kConsumerCheckMs, static_cast<int>(remaining)));
+        read = header_->read_pos.load(std::memory_order_acquire);
+    }
+    return true;
+}
+
+bool SharedResultSink::consumerAlive() const {
+    return SharedProcess::isAlive(header_->consumer_pid.load(std::memory_order_acquire));
+}
+
+uint64_t SharedResultSink::published() const {
+    return header_ ? header_->published.load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t SharedResultSink::dropped() const {
+    return header_ ? header_->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+uint8_t* SharedResultSink::reserve(size_t bytes, int timeout_ms, size_t& padding) {
+    uint64_t write = header_->write_pos.load(std::memory_order_relaxed);
+    uint64_t offset = write & (capacity_ - 1);
+    uint64_t contiguous = capacity_ - offset;
+    padding = bytes > contiguous ? static_cast<size_t>(contiguous) : 0;
+    uint64_t needed = bytes + padding;
+    if (needed > capacity_) {
+        return nullptr;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (capacity_ - (write - header_->read_pos.load(std::memory_order_acquire)) < needed) {
+        if (!consumerAlive()) {
+            return nullptr;
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) {
+            return nullptr;
+        }
+
+        // 先声明等待再复查，消费者释放后一定能看到该标记并发出唤醒
+        uint32_t seq = header_->space_seq.load(std::memory_order_acquire);
+        header_->producer_waiting.store(1);
+        if (capacity_ - (write - header_->read_pos.load()) >= needed) {
+            break;
+        }
+        // 消费者异常退出时不会再唤醒，按短间隔复查其是否存活
+        space_signal_.wait(seq, std::min(kConsumerCheckMs, static_cast<int>(remaining)));
+    }
+
+    if (padding > 0) {
+        SharedRecordHeader pad = {};
+        pad.size = static_cast<uint32_t>(padding);
+        pad.type = kSharedRecordPadding;
+        std::memcpy(ring_data_ + offset, &pad, sizeof(pad));
+        return ring_data_;
+    }
+    return ring_data_ + offset;
+}
+
+bool SharedResultSink::publish(
+    const std::string& building_id,
+    const SsPtr& skeleton,
+    const RoofMetrics& metrics,
+    const std::vector<std::pair<std::vector<std::pair<double, double>>, bool>>& unfolded_faces,
+    const std::string& ridge_svg,
+    const std::string& unfolded_svg,
+    int timeout_ms
+) {
+    if (!header_ || !skeleton) {
+        return false;
+    }
+
+    SharedRecordHeader record = {};
+    record.type = kSharedRecordBuilding;
+    record.roof_angle = metrics.roof_angle;
+    record.vertex_count = static_cast<uint32_t>(skeleton->size_of_vertices());
+    record.face_count = static_cast<uint32_t>(skeleton->size_of_faces());
+    for (auto fit = skeleton->faces_begin(); fit != skeleton->faces_end(); ++fit) {
+        auto he = fit->halfedge();
+        auto start = he;
+        do {
+            record.face_index_count++;
+            he = he->next();
+        } while (he != start);
+    }
+    record.unfolded_face_count = static_cast<uint32_t>(unfolded_faces.size());
+    for (const auto& face : unfolded_faces) {
+        record.unfolded_point_count += static_cast<uint32_t>(face.first.size());
+    }
+    record.building_id_bytes = static_cast<uint32_t>(building_id.size());
+    record.ridge_svg_bytes = static_cast<uint32_t>(ridge_svg.size());
+    record.unfolded_svg_bytes = static_cast<uint32_t>(unfolded_svg.size());
+
+    SharedRecordLayout layout = SharedRecordLayout::compute(record);
+    record.size = static_cast<uint32_t>(layout.size);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!header_) {
+        return false;
+    }
+
+    size_t padding = 0;
+    uint8_t* target = reserve(layout.size, timeout_ms, padding);
+    if (!target) {
+        uint64_t dropped = header_->dropped.fetch_add(1, std::memory_order_relaxed) + 1;
+        ROOF_LOG_WARNING("shm", "警告：共享内存缓冲区空间不足或无消费者，已丢弃 %s 的结果（累计丢弃 %llu 条）",
+                         building_id.c_str(), static_cast<unsigned long long>(dropped));
+        return false;
+    }
+
+    // 直接写入共享内存，不经过中间缓冲
+    record.sequence = ++sequence_;
+    std::memcpy(target, &record, sizeof(record));
+
+    double slope = std::tan(metrics.roof_angle * M_PI / 180.0);
+    std::unordered_map<const void*, uint32_t> vertex_index;
+    vertex_index.reserve(record.vertex_count);
+    double* vertices = reinterpret_cast<double*>(target + layout.vertices);
+    for (auto vit = skeleton->vertices_begin(); vit != skeleton->vertices_end(); ++vit) {
+        uint32_t index = static_cast<uint32_t>(vertex_index.size());
+        vertex_index[&*vit] = index;
+        vertices[3 * index] = vit->point().x();
+        vertices[3 * index + 1] = vit->point().y();
+        vertices[3 * index + 2] = vit->time() * slope;
+    }
+
+    uint32_t* face_offsets = reinterpret_cast<uint32_t*>(target + layout.face_offsets);
+    uint32_t* face_indices = reinterpret_cast<uint32_t*>(target + layout.face_indices);
+    uint8_t* face_gray = target + layout.face_gray;
+    bool has_gray = metrics.faces.size() == record.face_count;
+    uint32_t face = 0, index_count = 0;
+    for (auto fit = skeleton->faces_begin(); fit != skeleton->faces_end(); ++fit, ++face) {
+        face_offsets[face] = index_count;
+        auto he = fit->halfedge();
+        auto start = he;
+        do {
+            face_indices[index_count++] = vertex_index[&*he->vertex()];
+            he = he->next();
+        } while (he != start);
+        face_gray[face] = has_gray && metrics.faces[face].is_gray ? 1 : 0;
+    }
+    face_offsets[face] = index_count;
+
+    uint32_t* unfolded_offsets = reinterpret_cast<uint32_t*>(target + layout.unfolded_offsets);
+    double* unfolded_points = reinterpret_cast<double*>(target + layout.unfolded_points);
+    uint8_t* unfolded_gray = target + layout.unfolded_gray;
+    uint32_t point_count = 0;
+    for (size_t i = 0; i < unfolded_faces.size(); ++i) {
+        unfolded_offsets[i] = point_count;
+        for (const auto& point : unfolded_faces[i].first) {
+            unfolded_points[2 * point_count] = point.first;
+            unfolded_points[2 * point_count + 1] = point.second;
+            point_count++;
+        }
+        unfolded_gray[i] = unfolded_faces[i].second ? 1 : 0;
+    }
+    unfolded_offsets[unfolded_faces.size()] = point_count;
+
+    std::memcpy(target + layout.building_id, building_id.data(), building_id.size());
+    std::memcpy(target + layout.ridge_svg, ridge_svg.data(), ridge_svg.size());
+    std::memcpy(target + layout.unfolded_svg, unfolded_svg.data(), unfolded_svg.size());
+
+    // 发布：先推进写位置再递增序号，消费者声明了等待时才唤醒
+    header_->write_pos.store(header_->write_pos.load(std::memory_order_relaxed) + padding + layout.size);
+    header_->data_seq.fetch_add(1);
+    header_->published.fetch_add(1, std::memory_order_relaxed);
+    if (header_->consumer_waiting.exchange(0)) {
+        data_signal_.notify();
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "types.h"
+#include "shared_ring.h"
+#include "roof_statistics.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace RoofOutline {
+
+/**
+ * 共享内存结果输出模块（生产者）
+ * 把每栋建筑的骨架网格、展开面、灰色面标记以及可选的SVG直接序列化到共享内存环形缓冲区中，
+ * 同机的消费者进程（见 SharedResultReader）无需经过文件系统即可原地读取。布局见 shared_ring.h
+ */
+class SharedResultSink {
+public:
+    SharedResultSink() = default;
+    ~SharedResultSink();
+
+    /**
+     * 创建共享内存环形缓冲区
+     * @param name 共享内存名称（消费者以同一名称打开）
+     * @param capacity 数据区字节数（向上取整为 2 的幂）
+     * @return 是否成功
+     */
+    bool open(const std::string& name, size_t capacity);
+
+    /**
+     * 等待消费者读完所有已发布的记录
+     * 没有仍在运行的消费者时只等待 connect_timeout_ms 让其连接（为 0 时立即返回），之后最多再等待 timeout_ms
+     * @param timeout_ms 等待已连接的消费者读完的最长毫秒数
+     * @param connect_timeout_ms 等待消费者连接的最长毫秒数
+     * @return 是否已全部读完
+     */
+    bool drain(int timeout_ms, int connect_timeout_ms);
+
+    /**
+     * 关闭并删除共享内存名称（已连接的消费者仍可读完已映射的内容）
+     */
+    void close();
+
+    bool isOpen() const { return header_ != nullptr; }
+
+    /**
+     * 发布一栋建筑的结果（可在多个线程中并发调用，内部按调用顺序串行写入）
+     * @param building_id 建筑标识
+     * @param skeleton 直骨架（网格顶点高度由 time() 与屋顶倾斜角度换算）
+     * @param metrics 统计结果（提供倾斜角度和各屋面的灰色标记，面顺序与骨架一致）
+     * @param unfolded_faces 展开后的面信息（可为空）
+     * @param ridge_svg 屋脊线俯视图SVG（可为空）
+     * @param unfolded_svg 屋顶展开图SVG（可为空）
+     * @param timeout_ms 缓冲区满时最多等待的毫秒数；没有消费者连接或消费者已退出时不等待
+     * @return 是否发布成功（失败的记录计入丢弃数）
+     */
+    bool publish(
+        const std::string& building_id,
+        const SsPtr& skeleton,
+        const RoofMetrics& metrics,
+        const std::vector<std::pair<std::vector<std::pair<double, double>>, bool>>& unfolded_faces,
+        const std::string& ridge_svg,
+        const std::string& unfolded_svg,
+        int timeout_ms
+    );
+
+    /**
+     * 已发布的记录数
+     */
+    uint64_t published() const;
+
+    /**
+     * 已丢弃的记录数
+     */
+    uint64_t dropped() const;
+
+private:
+    SharedResultSink(const SharedResultSink&) = delete;
+    SharedResultSink& operator=(const SharedResultSink&) = delete;
+
+    /**
+     * 等待数据区有足够的连续空间，必要时先写入填充记录
+     * @param bytes 记录字节数
+     * @param timeout_ms 最多等待的毫秒数
+     * @param padding 输出填充记录占用的字节数
+     * @return 记录的写入位置；空间不足时为 nullptr
+     */
+    uint8_t* reserve(size_t bytes, int timeout_ms, size_t& padding);
+
+    /**
+     * 是否有仍在运行的消费者连接
+     */
+    bool consumerAlive() const;
+
+    SharedMemoryRegion region_;
+    SharedSignal data_signal_;
+    SharedSignal space_signal_;
+    SharedRingHeader* header_ = nullptr;
+    uint8_t* ring_data_ = nullptr;
+    uint64_t capacity_ = 0;
+    uint64_t sequence_ = 0;
+    std::mutex mutex_;
+};
+
+}
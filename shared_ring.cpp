@@ -0,0 +1,339 @@
+#include "shared_ring.h"
+#include "logger.h"
+#include <chrono>
+#include <climits>
+#include <thread>
+#include <type_traits>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <ctime>
+#endif
+#endif
+
+namespace RoofOutline {
+
+// 布局在进程间共享，原子量必须免锁且不含额外状态
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared ring requires lock-free 64-bit atomics");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared ring requires lock-free 32-bit atomics");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32-bit integer");
+static_assert(std::is_standard_layout<SharedRingHeader>::value, "shared ring header must be standard layout");
+static_assert(sizeof(SharedRecordHeader) % 8 == 0 && sizeof(SharedRecordHeader) <= 64,
+              "record header must keep 8-byte alignment and fit in the smallest record");
+
+namespace {
+
+size_t alignUp(size_t value) {
+    return (value + 7) & ~static_cast<size_t>(7);
+}
+
+#ifdef _WIN32
+std::string kernelObjectName(const std::string& name) {
+    return "Local\\roof_" + name;
+}
+#else
+std::string kernelObjectName(const std::string& name) {
+    return "/roof_" + name;
+}
+#endif
+
+}
+
+SharedRecordLayout SharedRecordLayout::compute(const SharedRecordHeader& header) {
+    SharedRecordLayout layout;
+    size_t offset = sizeof(SharedRecordHeader);
+    auto section = [&offset](size_t& start, size_t bytes) {
+        start = offset;
+        offset = alignUp(offset + bytes);
+    };
+
+    section(layout.vertices, sizeof(double) * 3 * header.vertex_count);
+    section(layout.face_offsets, sizeof(uint32_t) * (static_cast<size_t>(header.face_count) + 1));
+    section(layout.face_indices, sizeof(uint32_t) * header.face_index_count);
+    section(layout.face_gray, header.face_count);
+    section(layout.unfolded_offsets, sizeof(uint32_t) * (static_cast<size_t>(header.unfolded_face_count) + 1));
+    section(layout.unfolded_points, sizeof(double) * 2 * header.unfolded_point_count);
+    section(layout.unfolded_gray, header.unfolded_face_count);
+    section(layout.building_id, header.building_id_bytes);
+    section(layout.ridge_svg, header.ridge_svg_bytes);
+    section(layout.unfolded_svg, header.unfolded_svg_bytes);
+    layout.size = (offset + 63) & ~static_cast<size_t>(63);
+    return layout;
+}
+
+#ifdef _WIN32
+
+uint32_t SharedProcess::currentId() {
+    return static_cast<uint32_t>(GetCurrentProcessId());
+}
+
+bool SharedProcess::isAlive(uint32_t pid) {
+    if (pid == 0) {
+        return false;
+    }
+    HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, static_cast<DWORD>(pid));
+    if (!process) {
+        // 无权打开说明进程存在
+        return GetLastError() == ERROR_ACCESS_DENIED;
+    }
+    bool alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+    CloseHandle(process);
+    return alive;
+}
+
+#else
+
+uint32_t SharedProcess::currentId() {
+    return static_cast<uint32_t>(getpid());
+}
+
+bool SharedProcess::isAlive(uint32_t pid) {
+    if (pid == 0) {
+        return false;
+    }
+    // 信号 0 只做存在与权限检查；EPERM 说明进程存在但属于其他用户
+    return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+}
+
+#endif
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool SharedMemoryRegion::create(const std::string& name, size_t size) {
+    close();
+    std::string object_name = kernelObjectName(name);
+    uint64_t bytes = size;
+    mapping_ = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                  static_cast<DWORD>(bytes >> 32), static_cast<DWORD>(bytes & 0xffffffffu),
+                                  object_name.c_str());
+    if (!mapping_) {
+        ROOF_LOG_ERROR("shm", "无法创建共享内存 %s（错误码 %lu）", object_name.c_str(), GetLastError());
+        return false;
+    }
+    // 同名映射仍有进程持有句柄时 CreateFileMappingA 会直接打开旧映射（大小与内容都是旧的），不能沿用
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        ROOF_LOG_ERROR("shm", "共享内存 %s 已存在（另一个生产者正在运行，或上一次的消费者尚未断开）", object_name.c_str());
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+        return false;
+    }
+    data_ = static_cast<uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, size));
+    if (!data_) {
+        ROOF_LOG_ERROR("shm", "无法映射共享内存 %s（错误码 %lu）", object_name.c_str(), GetLastError());
+        close();
+        return false;
+    }
+    size_ = size;
+    name_ = name;
+    owner_ = true;
+    return true;
+}
+
+bool SharedMemoryRegion::open(const std::string& name) {
+    close();
+    std::string object_name = kernelObjectName(name);
+    mapping_ = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, object_name.c_str());
+    if (!mapping_) {
+        // 生产者尚未创建属于正常情况，由调用方决定是否重试
+        DWORD error = GetLastError();
+        if (error == ERROR_FILE_NOT_FOUND) {
+            ROOF_LOG_DEBUG("shm", "共享内存 %s 尚未创建", object_name.c_str());
+        } else {
+            ROOF_LOG_ERROR("shm", "无法打开共享内存 %s（错误码 %lu）", object_name.c_str(), error);
+        }
+        return false;
+    }
+    data_ = static_cast<uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+    MEMORY_BASIC_INFORMATION info;
+    if (!data_ || VirtualQuery(data_, &info, sizeof(info)) == 0) {
+        ROOF_LOG_ERROR("shm", "无法映射共享内存 %s（错误码 %lu）", object_name.c_str(), GetLastError());
+        close();
+        return false;
+    }
+    size_ = info.RegionSize;
+    name_ = name;
+    owner_ = false;
+    return true;
+}
+
+void SharedMemoryRegion::close() {
+    // 命名文件映射在最后一个句柄关闭时自动删除
+    if (data_) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_) {
+        CloseHandle(mapping_);
+    }
+    data_ = nullptr;
+    mapping_ = nullptr;
+    size_ = 0;
+    owner_ = false;
+}
+
+#else
+
+bool SharedMemoryRegion::create(const std::string& name, size_t size) {
+    close();
+    std::string object_name = kernelObjectName(name);
+    shm_unlink(object_name.c_str());
+    int fd = shm_open(object_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        ROOF_LOG_ERROR("shm", "无法创建共享内存 %s: %s", object_name.c_str(), std::strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ROOF_LOG_ERROR("shm", "无法设置共享内存大小 %s: %s", object_name.c_str(), std::strerror(errno));
+        ::close(fd);
+        shm_unlink(object_name.c_str());
+        return false;
+    }
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        ROOF_LOG_ERROR("shm", "无法映射共享内存 %s: %s", object_name.c_str(), std::strerror(errno));
+        shm_unlink(object_name.c_str());
+        return false;
+    }
+    data_ = static_cast<uint8_t*>(data);
+    size_ = size;
+    name_ = name;
+    owner_ = true;
+    return true;
+}
+
+bool SharedMemoryRegion::open(const std::string& name) {
+    close();
+    std::string object_name = kernelObjectName(name);
+    int fd = shm_open(object_name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        // 生产者尚未创建属于正常情况，由调用方决定是否重试
+        if (errno == ENOENT) {
+            ROOF_LOG_DEBUG("shm", "共享内存 %s 尚未创建", object_name.c_str());
+        } else {
+            ROOF_LOG_ERROR("shm", "无法打开共享内存 %s: %s", object_name.c_str(), std::strerror(errno));
+        }
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < 0) {
+        ROOF_LOG_ERROR("shm", "共享内存 %s 大小无效", object_name.c_str());
+        ::close(fd);
+        return false;
+    }
+    if (info.st_size == 0) {
+        // 生产者已创建名称但尚未设置大小
+        ROOF_LOG_DEBUG("shm", "共享内存 %s 尚未创建完成", object_name.c_str());
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        ROOF_LOG_ERROR("shm", "无法映射共享内存 %s: %s", object_name.c_str(), std::strerror(errno));
+        return false;
+    }
+    data_ = static_cast<uint8_t*>(data);
+    size_ = size;
+    name_ = name;
+    owner_ = false;
+    return true;
+}
+
+void SharedMemoryRegion::close() {
+    if (data_) {
+        munmap(data_, size_);
+    }
+    if (owner_) {
+        shm_unlink(kernelObjectName(name_).c_str());
+    }
+    data_ = nullptr;
+    size_ = 0;
+    owner_ = false;
+}
+
+#endif
+
+SharedSignal::~SharedSignal() {
+    close();
+}
+
+bool SharedSignal::open(const std::string& name, std::atomic<uint32_t>* word) {
+    close();
+    word_ = word;
+#ifdef _WIN32
+    // 自动复位事件：唤醒在等待者消费之前一直保持有信号，不会丢失
+    event_ = CreateEventA(nullptr, FALSE, FALSE, kernelObjectName(name).c_str());
+    if (!event_) {
+        ROOF_LOG_ERROR("shm", "无法创建通知事件 %s（错误码 %lu）", kernelObjectName(name).c_str(), GetLastError());
+        word_ = nullptr;
+        return false;
+    }
+#else
+    (void)name;
+#endif
+    return true;
+}
+
+void SharedSignal::close() {
+#ifdef _WIN32
+    if (event_) {
+        CloseHandle(event_);
+    }
+    event_ = nullptr;
+#endif
+    word_ = nullptr;
+}
+
+void SharedSignal::wait(uint32_t expected, int timeout_ms) const {
+    if (!word_ || word_->load(std::memory_order_acquire) != expected) {
+        return;
+    }
+#if defined(_WIN32)
+    WaitForSingleObject(event_, timeout_ms < 0 ? INFINITE : static_cast<DWORD>(timeout_ms));
+#elif defined(__linux__)
+    // 非 PRIVATE 的 futex 以物理页定位，可在映射同一共享内存的进程之间使用
+    struct timespec timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000L;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word_), FUTEX_WAIT, expected,
+            timeout_ms < 0 ? nullptr : &timeout, nullptr, 0);
+#else
+    (void)timeout_ms;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#endif
+}
+
+void SharedSignal::notify() const {
+    if (!word_) {
+        return;
+    }
+#if defined(_WIN32)
+    SetEvent(event_);
+#elif defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word_), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace RoofOutline {
+
+/**
+ * 共享内存结果环形缓冲区的布局（生产者与消费者进程共用，版本 2）
+ *
+ * 共享内存 = SharedRingHeader | 数据区（capacity 字节，capacity 为 2 的幂）
+ * 单生产者单消费者：write_pos / read_pos 为累计字节数，对 capacity 取模即为数据区内偏移。
+ * 数据区由连续的记录组成，每条记录以 SharedRecordHeader 开头、总长 64 字节对齐，且不会跨越数据区末尾：
+ * 末尾剩余空间不足时生产者先写一条 kSharedRecordPadding 记录占满末尾，再从数据区开头写入。
+ *
+ * 建筑结果记录（kSharedRecordBuilding）在记录头之后依次存放以下各段，每段起点 8 字节对齐
+ * （各段偏移由 SharedRecordLayout::compute 根据记录头中的数量算出）：
+ *   vertices          double[3 * vertex_count]          骨架网格顶点 x, y, z（z 为屋面高度）
+ *   face_offsets      uint32[face_count + 1]            各屋面在 face_indices 中的起止位置
+ *   face_indices      uint32[face_index_count]          屋面顶点下标（逆时针）
+ *   face_gray         uint8[face_count]                 屋面是否为灰色面
+ *   unfolded_offsets  uint32[unfolded_face_count + 1]   各展开面在 unfolded_points 中的起止位置
+ *   unfolded_points   double[2 * unfolded_point_count]  展开面顶点 x, y
+ *   unfolded_gray     uint8[unfolded_face_count]        展开面是否为灰色面
+ *   building_id       char[building_id_bytes]           建筑标识（UTF-8，不含结尾 0）
+ *   ridge_svg         char[ridge_svg_bytes]             屋脊线俯视图 SVG（可为空）
+ *   unfolded_svg      char[unfolded_svg_bytes]          屋顶展开图 SVG（可为空）
+ *
+ * 通知：data_seq / space_seq 为 32 位序号字，每次发布 / 释放记录后加一。
+ * Linux 上直接对共享内存中的序号字使用 futex 等待与唤醒；Windows 上使用同名的命名事件；
+ * 其他平台退化为短间隔轮询。只有对方声明正在等待（*_waiting 非 0）时才发出唤醒，避免多余的系统调用。
+ * 生产者关闭时置 producer_closed 并唤醒消费者；消费者读完剩余记录后应断开，再等待下一次创建的缓冲区。
+ *
+ * 创建：共享内存名称在头部写完之前就对其他进程可见（POSIX 上大小还可能为 0）。生产者写完头部其余字段
+ * 与通知对象后，最后以 release 语义写入 version；消费者以 acquire 读取，大小为 0 或 version 为 0 都视为尚未创建。
+ *
+ * 连接：consumer_pid 记录当前消费者的进程号（0 为无消费者）。消费者异常退出时来不及清零，
+ * 因此双方都以进程是否存活为准：生产者视已退出的消费者为未连接，新的消费者可以接管已退出者的连接
+ */
+const char kSharedRingMagic[8] = {'R', 'O', 'O', 'F', 'R', 'I', 'N', 'G'};
+const uint32_t kSharedRingVersion = 2;
+const uint32_t kSharedRecordPadding = 0;
+const uint32_t kSharedRecordBuilding = 1;
+
+struct SharedRingHeader {
+    char magic[8];                              // "ROOFRING"
+    std::atomic<uint32_t> version;              // kSharedRingVersion；生产者最后写入，0 表示头部尚未写完
+    uint32_t header_bytes;                      // 本结构大小，数据区从此偏移开始
+    uint64_t capacity;                          // 数据区字节数
+
+    alignas(64) std::atomic<uint64_t> write_pos;    // 生产者：已发布的累计字节数
+    std::atomic<uint64_t> published;            // 已发布的建筑记录数
+    std::atomic<uint64_t> dropped;              // 因缓冲区满或无消费者而丢弃的记录数
+    std::atomic<uint32_t> data_seq;             // 每发布一条记录加一（消费者在此等待）
+    std::atomic<uint32_t> consumer_waiting;     // 消费者正在等待新记录
+    std::atomic<uint32_t> producer_closed;      // 生产者已关闭，不会再发布新记录
+
+    alignas(64) std::atomic<uint64_t> read_pos;     // 消费者：已释放的累计字节数
+    std::atomic<uint32_t> space_seq;            // 每释放一条记录加一（生产者在此等待）
+    std::atomic<uint32_t> producer_waiting;     // 生产者正在等待空闲空间
+    std::atomic<uint32_t> consumer_pid;         // 已连接消费者的进程号，0 为无消费者
+};
+
+struct SharedRecordHeader {
+    uint32_t size;                  // 记录总字节数（含记录头，64 字节对齐）
+    uint32_t type;                  // kSharedRecordPadding / kSharedRecordBuilding
+    uint64_t sequence;              // 建筑记录序号（从 1 开始）
+    double roof_angle;              // 屋顶倾斜角度（度）
+    uint32_t vertex_count;
+    uint32_t face_count;
+    uint32_t face_index_count;
+    uint32_t unfolded_face_count;
+    uint32_t unfolded_point_count;
+    uint32_t building_id_bytes;
+    uint32_t ridge_svg_bytes;
+    uint32_t unfolded_svg_bytes;
+};
+
+/**
+ * 建筑结果记录中各段相对记录起点的字节偏移
+ */
+struct SharedRecordLayout {
+    size_t vertices = 0;
+    size_t face_offsets = 0;
+    size_t face_indices = 0;
+    size_t face_gray = 0;
+    size_t unfolded_offsets = 0;
+    size_t unfolded_points = 0;
+    size_t unfolded_gray = 0;
+    size_t building_id = 0;
+    size_t ridge_svg = 0;
+    size_t unfolded_svg = 0;
+    size_t size = 0;                // 记录总字节数（64 字节对齐，保证末尾剩余空间总能放下填充记录头）
+
+    /**
+     * 根据记录头中的各项数量计算布局
+     */
+    static SharedRecordLayout compute(const SharedRecordHeader& header);
+};
+
+/**
+ * 进程号与存活检测（用于识别异常退出后未断开的消费者）
+ */
+class SharedProcess {
+public:
+    /**
+     * 当前进程号
+     */
+    static uint32_t currentId();
+
+    /**
+     * 进程是否仍在运行（进程号被系统复用时可能误判为存活）
+     * @param pid 进程号，0 视为不存在
+     */
+    static bool isAlive(uint32_t pid);
+};
+
+/**
+ * 跨进程共享内存区域
+ * Windows 上为命名文件映射（Local\ 命名空间），POSIX 上为 shm_open 共享内存对象
+ */
+class SharedMemoryRegion {
+public:
+    SharedMemoryRegion() = default;
+    ~SharedMemoryRegion();
+
+    /**
+     * 创建指定大小的共享内存，由生产者调用，关闭时删除名称
+     * POSIX 上同名对象已存在时先删除名称再重建（已映射的进程不受影响）；
+     * Windows 上同名映射仍被其他进程持有时无法重建，返回 false
+     * @param name 共享内存名称（只含字母、数字、下划线）
+     * @param size 字节数
+     * @return 是否成功
+     */
+    bool create(const std::string& name, size_t size);
+
+    /**
+     * 打开已存在的共享内存，由消费者调用
+     * @param name 共享内存名称
+     * @return 是否成功
+     */
+    bool open(const std::string& name);
+
+    /**
+     * 解除映射；若为创建者则同时删除名称（已映射的进程不受影响）
+     */
+    void close();
+
+    uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+    SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    std::string name_;
+    bool owner_ = false;
+#ifdef _WIN32
+    void* mapping_ = nullptr;
+#endif
+};
+
+/**
+ * 跨进程等待/唤醒（以共享内存中的 32 位序号字为条件）
+ */
+class SharedSignal {
+public:
+    SharedSignal() = default;
+    ~SharedSignal();
+
+    /**
+     * 绑定序号字
+     * @param name 通知名称（Windows 上用作命名事件名称，两端须一致）
+     * @param word 共享内存中的序号字
+     * @return 是否成功
+     */
+    bool open(const std::string& name, std::atomic<uint32_t>* word);
+
+    void close();
+
+    /**
+     * 序号字仍等于 expected 时阻塞，直到被唤醒或超时；可能提前返回，调用方需重新检查条件
+     * @param expected 调用方读到的序号
+     * @param timeout_ms 超时（毫秒）
+     */
+    void wait(uint32_t expected, int timeout_ms) const;
+
+    /**
+     * 唤醒所有在该序号字上等待的进程
+     */
+    void notify() const;
+
+private:
+    SharedSignal(const SharedSignal&) = delete;
+    SharedSignal& operator=(const SharedSignal&) = delete;
+
+    std::atomic<uint32_t>* word_ = nullptr;
+#ifdef _WIN32
+    void* event_ = nullptr;
+#endif
+};
+
+}
@@ -1,29 +1,51 @@
 #include "svg_renderer.h"
+#include "geometry.h"
+#include "logger.h"
 #include <fstream>
-#include <iostream>
 #include <cmath>
 #include <filesystem>
 
 namespace RoofOutline {
 
-bool SVGRenderer::isNearPoint(double x, double y, double tx, double ty, double epsilon) {
-    return std::abs(x - tx) < epsilon && std::abs(y - ty) < epsilon;
+std::string SVGRenderer::outputLocation(const std::string& filename) {
+    // 工作目录在运行期间不变，只查询一次
+    static const std::filesystem::path working_directory = std::filesystem::current_path();
+    return (working_directory / filename).string();
 }
 
-bool SVGRenderer::containsGrayVertex(
-    const std::vector<std::pair<double, double>>& face_vertices,
-    const std::vector<std::pair<double, double>>& gray_vertices
+void SVGRenderer::writeOffsetLayer(
+    std::ostream& svg_file,
+    const char* layer_id,
+    const char* stroke_color,
+    const std::vector<OffsetOutline>& offsets,
+    bool exterior,
+    const CoordinateTransform& transform
 ) {
-    int match_count = 0;
-    for (const auto& fv : face_vertices) {
-        for (const auto& gv : gray_vertices) {
-            if (isNearPoint(fv.first, fv.second, gv.first, gv.second)) {
-                match_count++;
-                break;
+    bool any = false;
+    for (const auto& outline : offsets) {
+        any = any || ((outline.distance < 0) == exterior && !outline.rings.empty());
+    }
+    if (!any) {
+        return;
+    }
+
+    svg_file << "<g id=\"" << layer_id << "\" fill=\"none\" stroke=\"" << stroke_color
+        << "\" stroke-width=\"1.5\" stroke-dasharray=\"6,4\">\n";
+    for (const auto& outline : offsets) {
+        if ((outline.distance < 0) != exterior || outline.rings.empty()) {
+            continue;
+        }
+        svg_file << "  <path data-distance=\"" << std::abs(outline.distance) << "\" d=\"";
+        for (const auto& ring : outline.rings) {
+            for (size_t i = 0; i < ring.size(); ++i) {
+                svg_file << (i == 0 ? "M" : "L") << transform.toSVGX(ring[i].first) << ","
+                    << transform.toSVGY(ring[i].second) << " ";
             }
+            svg_file << "Z ";
         }
+        svg_file << "\" />\n";
     }
-    return match_count >= 3; // 至少包含3个指定顶点才填充灰色
+    svg_file << "</g>\n\n";
 }
 
 bool SVGRenderer::renderRidgeView(
@@ -31,14 +53,34 @@ bool SVGRenderer::renderRidgeView(
     const Polygon_2& polygon,
     const SsPtr& skeleton,
     const CoordinateTransform& transform,
-    const std::vector<std::pair<double, double>>& gray_vertices
+    const std::vector<std::pair<double, double>>& gray_vertices,
+    const std::vector<OffsetOutline>& offsets
 ) {
     std::ofstream svg_file(filename);
     if (!svg_file) {
-        std::cerr << "无法创建 SVG 文件: " << filename << std::endl;
+        ROOF_LOG_ERROR("svg", "无法创建 SVG 文件: %s", filename.c_str());
         return false;
     }
 
+    if (!renderRidgeView(svg_file, polygon, skeleton, transform, gray_vertices, offsets)) {
+        ROOF_LOG_ERROR("svg", "写入 SVG 文件失败: %s", filename.c_str());
+        return false;
+    }
+    svg_file.close();
+
+    ROOF_LOG_INFO("svg", "✓ SVG 文件已生成: %s（文件位置: %s）", filename.c_str(), outputLocation(filename).c_str());
+
+    return true;
+}
+
+bool SVGRenderer::renderRidgeView(
+    std::ostream& svg_file,
+    const Polygon_2& polygon,
+    const SsPtr& skeleton,
+    const CoordinateTransform& transform,
+    const std::vector<std::pair<double, double>>& gray_vertices,
+    const std::vector<OffsetOutline>& offsets
+) {
     int svg_width = transform.getSVGWidth();
     int svg_height = transform.getSVGHeight();
 
@@ -70,7 +112,7 @@ bool SVGRenderer::renderRidgeView(
         } while (he != start);
 
         // 判断是否应该填充灰色
-        bool is_gray = containsGrayVertex(face_svg_vertices, gray_vertices);
+        bool is_gray = Geometry::containsGrayVertex(face_svg_vertices, gray_vertices);
         std::string fill_color = is_gray ? "#9e9e9e" : "#e3f2fd";
 
         // 绘制多边形
@@ -82,6 +124,9 @@ bool SVGRenderer::renderRidgeView(
     }
     svg_file << "</g>\n\n";
 
+    // 挑檐轮廓（外部直骨架偏移）
+    writeOffsetLayer(svg_file, "eave-overhang", "#388e3c", offsets, true, transform);
+
     // 绘制外轮廓多边形
     svg_file << "<!-- 屋顶外轮廓 -->\n";
     svg_file << "<polygon points=\"";
@@ -90,6 +135,9 @@ bool SVGRenderer::renderRidgeView(
     }
     svg_file << "\" fill=\"none\" stroke=\"#1976d2\" stroke-width=\"2\" />\n\n";
 
+    // 向内偏移轮廓（内部直骨架等高线）
+    writeOffsetLayer(svg_file, "offset-lines", "#f57c00", offsets, false, transform);
+
     // 绘制屋脊线（骨架边）
     svg_file << "<!-- 屋脊线（内部骨架边）-->\n";
     svg_file << "<g id=\"ridge-lines\" stroke=\"#d32f2f\" stroke-width=\"2.5\" stroke-linecap=\"round\">\n";
@@ -131,12 +179,8 @@ bool SVGRenderer::renderRidgeView(
     svg_file << "</g>\n\n";
 
     svg_file << "</svg>\n";
-    svg_file.close();
-
-    std::cout << "✓ SVG 文件已生成: " << filename << std::endl;
-    std::cout << "  文件位置: " << std::filesystem::current_path().string() << "\\" << filename << std::endl;
 
-    return true;
+    return static_cast<bool>(svg_file);
 }
 
 bool SVGRenderer::renderUnfoldedView(
@@ -147,10 +191,27 @@ bool SVGRenderer::renderUnfoldedView(
 ) {
     std::ofstream unfold_svg(filename);
     if (!unfold_svg) {
-        std::cerr << "无法创建展开图 SVG 文件: " << filename << std::endl;
+        ROOF_LOG_ERROR("svg", "无法创建展开图 SVG 文件: %s", filename.c_str());
+        return false;
+    }
+
+    if (!renderUnfoldedView(unfold_svg, unfolded_faces, transform, roof_angle)) {
+        ROOF_LOG_ERROR("svg", "写入展开图 SVG 文件失败: %s", filename.c_str());
         return false;
     }
+    unfold_svg.close();
+
+    ROOF_LOG_INFO("svg", "✓ 展开图 SVG 文件已生成: %s（文件位置: %s）", filename.c_str(), outputLocation(filename).c_str());
 
+    return true;
+}
+
+bool SVGRenderer::renderUnfoldedView(
+    std::ostream& unfold_svg,
+    const std::vector<std::pair<std::vector<std::pair<double, double>>, bool>>& unfolded_faces,
+    const CoordinateTransform& transform,
+    double roof_angle
+) {
     int svg_width = transform.getSVGWidth();
     int svg_height = transform.getSVGHeight();
 
@@ -198,12 +259,8 @@ bool SVGRenderer::renderUnfoldedView(
 
     // SVG 结束
     unfold_svg << "</svg>\n";
-    unfold_svg.close();
 
-    std::cout << "✓ 展开图 SVG 文件已生成: " << filename << std::endl;
-    std::cout << "  文件位置: " << std::filesystem::current_path().string() << "\\" << filename << std::endl;
-
-    return true;
+    return static_cast<bool>(unfold_svg);
 }
 
 } 
@@ -2,6 +2,8 @@
 
 #include "types.h"
 #include "coordinate_transform.h"
+#include "roof_offsets.h"
+#include <ostream>
 #include <string>
 #include <vector>
 #include <utility>
@@ -21,6 +23,7 @@ public:
      * @param skeleton 直骨架
      * @param transform 坐标转换器
      * @param gray_vertices 需要标记为灰色的特殊顶点（SVG坐标）
+     * @param offsets 附加绘制的偏移轮廓（挑檐画在轮廓外侧图层，内收线画在屋脊线下方）
      * @return 是否成功
      */
     static bool renderRidgeView(
@@ -28,7 +31,22 @@ public:
         const Polygon_2& polygon,
         const SsPtr& skeleton,
         const CoordinateTransform& transform,
-        const std::vector<std::pair<double, double>>& gray_vertices
+        const std::vector<std::pair<double, double>>& gray_vertices,
+        const std::vector<OffsetOutline>& offsets = std::vector<OffsetOutline>()
+    );
+
+    /**
+     * 渲染屋脊线俯视图到输出流（参数同上，用于在内存中生成SVG）
+     * @param svg_file 输出流
+     * @return 是否成功
+     */
+    static bool renderRidgeView(
+        std::ostream& svg_file,
+        const Polygon_2& polygon,
+        const SsPtr& skeleton,
+        const CoordinateTransform& transform,
+        const std::vector<std::pair<double, double>>& gray_vertices,
+        const std::vector<OffsetOutline>& offsets = std::vector<OffsetOutline>()
     );
 
     /**
@@ -46,18 +64,34 @@ public:
         double roof_angle
     );
 
+    /**
+     * 渲染屋顶展开图到输出流（参数同上，用于在内存中生成SVG）
+     * @param unfold_svg 输出流
+     * @return 是否成功
+     */
+    static bool renderUnfoldedView(
+        std::ostream& unfold_svg,
+        const std::vector<std::pair<std::vector<std::pair<double, double>>, bool>>& unfolded_faces,
+        const CoordinateTransform& transform,
+        double roof_angle
+    );
+
 private:
     /**
-     * 检查顶点是否接近目标点
+     * 输出文件的完整路径（工作目录只查询一次）
      */
-    static bool isNearPoint(double x, double y, double tx, double ty, double epsilon = 0.5);
+    static std::string outputLocation(const std::string& filename);
 
     /**
-     * 检查面是否包含灰色顶点
+     * 输出一组偏移轮廓图层（每个距离一条 path）
      */
-    static bool containsGrayVertex(
-        const std::vector<std::pair<double, double>>& face_vertices,
-        const std::vector<std::pair<double, double>>& gray_vertices
+    static void writeOffsetLayer(
+        std::ostream& svg_file,
+        const char* layer_id,
+        const char* stroke_color,
+        const std::vector<OffsetOutline>& offsets,
+        bool exterior,
+        const CoordinateTransform& transform
     );
 };
 
@@ -0,0 +1,247 @@
+// 轮廓修复扫描线求交回归测试
+// 对一组自交轮廓（随机整数网格、正交折线、多边交于一点、星形、随机实数坐标）分别用
+// PolygonRepair::findIntersectingEdges 与逐对检查所有边的暴力算法求需要拆分的边对，
+// 除端点距另一条边在容差附近的边对外要求两者完全一致。
+// 任一用例失败时返回非零退出码。
+
+#include "polygon_repair.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace RoofOutline;
+
+namespace {
+
+typedef std::vector<std::pair<double, double>> Outline;
+
+int g_failures = 0;
+int g_cases = 0;
+
+double orientation(const Point& a, const Point& b, const Point& c) {
+	return (b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x());
+}
+
+/**
+ * x 严格落在线段 ab 内部（不含端点）
+ */
+bool strictlyInside(const Point& x, const Point& a, const Point& b) {
+	if (orientation(a, b, x) != 0) {
+		return false;
+	}
+	double along_a = (x.x() - a.x()) * (b.x() - a.x()) + (x.y() - a.y()) * (b.y() - a.y());
+	double along_b = (x.x() - b.x()) * (a.x() - b.x()) + (x.y() - b.y()) * (a.y() - b.y());
+	return along_a > 0 && along_b > 0;
+}
+
+/**
+ * 暴力求交：两条不相邻的边在内部交叉，或一条边的端点严格落在另一条边内部
+ */
+std::vector<std::pair<int, int>> bruteForce(const std::vector<Point>& ring) {
+	std::vector<std::pair<int, int>> pairs;
+	int n = static_cast<int>(ring.size());
+	for (int e = 0; e < n; ++e) {
+		for (int f = e + 1; f < n; ++f) {
+			if (f == e + 1 || (f + 1) % n == e) {
+				continue;
+			}
+			const Point& p = ring[e];
+			const Point& p2 = ring[(e + 1) % n];
+			const Point& q = ring[f];
+			const Point& q2 = ring[(f + 1) % n];
+			double d1 = orientation(p, p2, q);
+			double d2 = orientation(p, p2, q2);
+			double d3 = orientation(q, q2, p);
+			double d4 = orientation(q, q2, p2);
+			bool crossing = ((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0));
+			if (crossing || strictlyInside(q, p, p2) || strictlyInside(q2, p, p2) ||
+				strictlyInside(p, q, q2) || strictlyInside(p2, q, q2)) {
+				pairs.push_back({e, f});
+			}
+		}
+	}
+	return pairs;
+}
+
+double distanceToEdge(const Point& x, const Point& a, const Point& b) {
+	double dx = b.x() - a.x(), dy = b.y() - a.y();
+	double t = ((x.x() - a.x()) * dx + (x.y() - a.y()) * dy) / (dx * dx + dy * dy);
+	t = std::max(0.0, std::min(1.0, t));
+	return std::hypot(x.x() - a.x() - t * dx, x.y() - a.y() - t * dy);
+}
+
+/**
+ * 某条边的端点到另一条边的距离在容差附近：修复按容差判断相接，与精确判断的结果可以不同
+ */
+bool borderline(const std::vector<Point>& ring, const std::pair<int, int>& pair, double tolerance) {
+	int n = static_cast<int>(ring.size());
+	const Point& p = ring[pair.first];
+	const Point& p2 = ring[(pair.first + 1) % n];
+	const Point& q = ring[pair.second];
+	const Point& q2 = ring[(pair.second + 1) % n];
+	return distanceToEdge(q, p, p2) <= tolerance || distanceToEdge(q2, p, p2) <= tolerance ||
+		distanceToEdge(p, q, q2) <= tolerance || distanceToEdge(p2, q, q2) <= tolerance;
+}
+
+void check(const std::string& name, const Outline& outline) {
+	// 去掉重复相邻顶点（修复流程在求交前已删除）
+	std::vector<Point> ring;
+	for (const auto& point : outline) {
+		Point p(point.first, point.second);
+		if (ring.empty() || ring.back() != p) {
+			ring.push_back(p);
+		}
+	}
+	while (ring.size() > 1 && ring.back() == ring.front()) {
+		ring.pop_back();
+	}
+	if (ring.size() < 4) {
+		return;
+	}
+
+	double extent = 1.0;
+	for (const auto& p : ring) {
+		extent = std::max(extent, std::max(std::abs(p.x()), std::abs(p.y())));
+	}
+	double tolerance = 1e-8 * extent;
+
+	g_cases++;
+	auto expected = bruteForce(ring);
+	auto actual = PolygonRepair::findIntersectingEdges(ring);
+	std::vector<std::pair<int, int>> difference;
+	std::set_symmetric_difference(actual.begin(), actual.end(), expected.begin(), expected.end(),
+		std::back_inserter(difference));
+	for (const auto& pair : difference) {
+		if (!borderline(ring, pair, tolerance)) {
+			g_failures++;
+			std::printf("FAIL %s (%zu vertices): 扫描线找到 %zu 对，暴力求交 %zu 对，边 %d 与 %d 不一致\n",
+				name.c_str(), ring.size(), actual.size(), expected.size(), pair.first, pair.second);
+			break;
+		}
+	}
+}
+
+/**
+ * 在 size×size 的整数网格上随机取 n 个顶点（大量共线、重合与 T 形相接）
+ */
+Outline randomGrid(std::mt19937& rng, int n, int size) {
+	std::uniform_int_distribution<int> coordinate(0, size);
+	Outline outline;
+	for (int i = 0; i < n; ++i) {
+		outline.push_back({static_cast<double>(coordinate(rng)), static_cast<double>(coordinate(rng))});
+	}
+	return outline;
+}
+
+/**
+ * 随机正交折线：每步沿水平或竖直方向走若干格，最后沿两段正交边回到起点
+ */
+Outline randomRectilinear(std::mt19937& rng, int n, int size) {
+	std::uniform_int_distribution<int> coordinate(0, size);
+	Outline outline = {{0.0, 0.0}};
+	for (int i = 1; i < n; ++i) {
+		auto last = outline.back();
+		if (i % 2 == 1) {
+			outline.push_back({static_cast<double>(coordinate(rng)), last.second});
+		} else {
+			outline.push_back({last.first, static_cast<double>(coordinate(rng))});
+		}
+	}
+	outline.push_back({0.0, outline.back().second});
+	return outline;
+}
+
+/**
+ * 多条边交于原点：顶点依次为 v0, -v0, v1, -v1, ...
+ */
+Outline throughOrigin(std::mt19937& rng, int n) {
+	std::uniform_int_distribution<int> coordinate(-50, 50);
+	Outline outline;
+	for (int i = 0; i < n; ++i) {
+		double x = coordinate(rng), y = coordinate(rng);
+		if (x == 0 && y == 0) {
+			x = 1;
+		}
+		outline.push_back({x, y});
+		outline.push_back({-x, -y});
+	}
+	return outline;
+}
+
+/**
+ * 星形多边形 {n/k}：圆周上 n 个点按步长 k 连接
+ */
+Outline star(int n, int k, double radius) {
+	Outline outline;
+	for (int i = 0; i < n; ++i) {
+		double angle = 2 * M_PI * ((static_cast<long>(i) * k) % n) / n;
+		outline.push_back({radius * std::cos(angle), radius * std::sin(angle)});
+	}
+	return outline;
+}
+
+Outline randomReal(std::mt19937& rng, int n, double x0, double y0, double size) {
+	std::uniform_real_distribution<double> coordinate(0.0, size);
+	Outline outline;
+	for (int i = 0; i < n; ++i) {
+		outline.push_back({x0 + coordinate(rng), y0 + coordinate(rng)});
+	}
+	return outline;
+}
+
+}
+
+int main()
+{
+	std::mt19937 rng(20240702);
+	char name[64];
+
+	// 整数网格：共线重叠、T 形相接、重合顶点
+	for (int i = 0; i < 3000; ++i) {
+		std::snprintf(name, sizeof(name), "grid_%d", i);
+		check(name, randomGrid(rng, 4 + i % 40, 3 + i % 12));
+	}
+
+	// 正交折线：大量竖直边与共线重叠
+	for (int i = 0; i < 1000; ++i) {
+		std::snprintf(name, sizeof(name), "rectilinear_%d", i);
+		check(name, randomRectilinear(rng, 4 + 2 * (i % 30), 2 + i % 20));
+	}
+
+	// 多条边交于同一点
+	for (int i = 0; i < 200; ++i) {
+		std::snprintf(name, sizeof(name), "through_origin_%d", i);
+		check(name, throughOrigin(rng, 2 + i % 25));
+	}
+
+	// 星形：交点数为边数的平方量级
+	for (int n : {5, 7, 11, 50, 201}) {
+		for (int k : {2, 3, n / 2}) {
+			std::snprintf(name, sizeof(name), "star_%d_%d", n, k);
+			check(name, star(n, k, 100.0));
+		}
+	}
+
+	// 随机实数坐标，含大坐标
+	for (int i = 0; i < 200; ++i) {
+		std::snprintf(name, sizeof(name), "real_%d", i);
+		check(name, randomReal(rng, 4 + i % 60, 0.0, 0.0, 10.0));
+	}
+	for (int i = 0; i < 20; ++i) {
+		std::snprintf(name, sizeof(name), "large_coordinates_%d", i);
+		check(name, randomReal(rng, 20 + 10 * i, 500000.0, 4300000.0, 300.0));
+	}
+	check("large_random", randomReal(rng, 2000, 0.0, 0.0, 1000.0));
+
+	std::printf("%d/%d cases passed\n", g_cases - g_failures, g_cases);
+	return g_failures == 0 ? 0 : 1;
+}
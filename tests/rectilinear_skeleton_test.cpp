@@ -0,0 +1,290 @@
+// 正交多边形直骨架回归测试
+// 对一组正交多边形（网格、梳状、旋转、接近退化）分别用 RectilinearSkeleton 与 CGAL 计算内部直骨架，
+// 检查结构合法性并要求两者拓扑与顶点位置一致。任一用例失败时返回非零退出码。
+
+#include "rectilinear_skeleton.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace RoofOutline;
+
+namespace {
+
+typedef std::vector<std::pair<double, double>> Outline;
+
+int g_failures = 0;
+int g_cases = 0;
+
+/**
+ * 检查直骨架的结构：每条轮廓边对应一个逆时针屋面，半边首尾相接，
+ * 屋面面积之和等于多边形面积，顶点时间等于到所属轮廓边的距离
+ */
+bool checkStructure(const SsPtr& skeleton, const Polygon_2& polygon, double tolerance, std::string& reason) {
+	if (skeleton->size_of_faces() != polygon.size()) {
+		reason = "屋面数与轮廓边数不一致";
+		return false;
+	}
+
+	double area = 0.0;
+	for (auto fit = skeleton->faces_begin(); fit != skeleton->faces_end(); ++fit) {
+		auto contour = fit->halfedge();
+		Point p0 = contour->opposite()->vertex()->point();
+		Point p1 = contour->vertex()->point();
+		double length = std::hypot(p1.x() - p0.x(), p1.y() - p0.y());
+		if (length <= 0.0) {
+			reason = "轮廓边长度为零";
+			return false;
+		}
+
+		double face_area = 0.0;
+		size_t steps = 0;
+		auto he = contour;
+		do {
+			if (he->face() != fit || he->next()->prev() != he) {
+				reason = "半边链接不一致";
+				return false;
+			}
+			Point p = he->opposite()->vertex()->point();
+			Point q = he->vertex()->point();
+			face_area += p.x() * q.y() - q.x() * p.y();
+
+			double distance = ((p1.x() - p0.x()) * (q.y() - p0.y()) - (p1.y() - p0.y()) * (q.x() - p0.x())) / length;
+			if (std::abs(distance - he->vertex()->time()) > tolerance) {
+				reason = "顶点时间与到轮廓边的距离不一致";
+				return false;
+			}
+			he = he->next();
+			if (++steps > skeleton->size_of_halfedges()) {
+				reason = "屋面边界不闭合";
+				return false;
+			}
+		} while (he != contour);
+
+		if (face_area <= 0.0) {
+			reason = "屋面不是逆时针方向";
+			return false;
+		}
+		area += face_area / 2;
+	}
+
+	double polygon_area = polygon.area();
+	if (std::abs(area - polygon_area) > tolerance * std::max(1.0, polygon_area)) {
+		reason = "屋面面积之和与多边形面积不一致";
+		return false;
+	}
+	return true;
+}
+
+void check(const std::string& name, const Outline& outline) {
+	g_cases++;
+	Polygon_2 polygon;
+	double extent = 1.0;
+	for (const auto& point : outline) {
+		polygon.push_back(Point(point.first, point.second));
+		extent = std::max(extent, std::max(std::abs(point.first - outline[0].first), std::abs(point.second - outline[0].second)));
+	}
+	double tolerance = 1e-6 * extent;
+
+	std::string reason;
+	double rotation = 0.0;
+	SsPtr skeleton;
+	SsPtr reference;
+
+	if (!polygon.is_simple() || !polygon.is_counterclockwise_oriented()) {
+		reason = "测试多边形不是逆时针简单多边形";
+	} else if (!RectilinearSkeleton::isRectilinear(polygon, rotation)) {
+		reason = "未识别为正交多边形";
+	} else if (!(skeleton = RectilinearSkeleton::create(polygon))) {
+		reason = "正交多边形直骨架计算失败";
+	} else if (!checkStructure(skeleton, polygon, tolerance, reason)) {
+		// reason 已填写
+	} else if (!(reference = CGAL::create_interior_straight_skeleton_2(polygon))) {
+		reason = "CGAL 直骨架计算失败";
+	} else if (!RectilinearSkeleton::sameTopology(skeleton, reference, tolerance)) {
+		reason = "与 CGAL 结果不一致";
+	}
+
+	if (!reason.empty()) {
+		g_failures++;
+		std::printf("FAIL %s (%zu vertices): %s\n", name.c_str(), outline.size(), reason.c_str());
+	}
+}
+
+/**
+ * 在 n×n 网格上随机生长一片四连通、无空洞、无对角相接的格子，返回其逆时针外轮廓（去掉共线点）
+ */
+Outline randomGrid(std::mt19937& rng, int n) {
+	std::vector<std::vector<int>> filled(n + 2, std::vector<int>(n + 2, 0));
+	filled[n / 2 + 1][n / 2 + 1] = 1;
+	int count = 1;
+	std::uniform_int_distribution<int> cell(1, n);
+	for (int attempt = 0; attempt < n * n * 3 && count < n * n / 2; ++attempt) {
+		int x = cell(rng), y = cell(rng);
+		if (filled[x][y]) {
+			continue;
+		}
+		int ring[8] = {filled[x + 1][y], filled[x + 1][y + 1], filled[x][y + 1], filled[x - 1][y + 1],
+		               filled[x - 1][y], filled[x - 1][y - 1], filled[x][y - 1], filled[x + 1][y - 1]};
+		// 周围已填格子必须连续，且不能只在对角方向相接，否则会产生空洞或夹点
+		int transitions = 0;
+		bool ok = ring[0] || ring[2] || ring[4] || ring[6];
+		for (int k = 0; k < 8; ++k) {
+			transitions += ring[k] != ring[(k + 1) % 8];
+			if (k % 2 == 1 && ring[k] && !ring[k - 1] && !ring[(k + 1) % 8]) {
+				ok = false;
+			}
+		}
+		if (!ok || transitions != 2) {
+			continue;
+		}
+		filled[x][y] = 1;
+		count++;
+	}
+
+	std::map<std::pair<int, int>, std::pair<int, int>> next;
+	for (int x = 1; x <= n; ++x) {
+		for (int y = 1; y <= n; ++y) {
+			if (!filled[x][y]) {
+				continue;
+			}
+			if (!filled[x][y - 1]) next[{x, y}] = {x + 1, y};
+			if (!filled[x + 1][y]) next[{x + 1, y}] = {x + 1, y + 1};
+			if (!filled[x][y + 1]) next[{x + 1, y + 1}] = {x, y + 1};
+			if (!filled[x - 1][y]) next[{x, y + 1}] = {x, y};
+		}
+	}
+
+	std::vector<std::pair<int, int>> ring;
+	auto start = next.begin()->first;
+	auto current = start;
+	do {
+		ring.push_back(current);
+		current = next[current];
+	} while (current != start);
+
+	Outline outline;
+	size_t m = ring.size();
+	for (size_t i = 0; i < m; ++i) {
+		auto a = ring[(i + m - 1) % m], b = ring[i], c = ring[(i + 1) % m];
+		long cross = static_cast<long>(b.first - a.first) * (c.second - b.second) -
+		             static_cast<long>(b.second - a.second) * (c.first - b.first);
+		if (cross != 0) {
+			outline.push_back({static_cast<double>(b.first), static_cast<double>(b.second)});
+		}
+	}
+	return outline;
+}
+
+/**
+ * 阶梯形多边形：steps 级台阶，每级宽 run、高 rise
+ */
+Outline staircase(int steps, double run, double rise) {
+	Outline outline = {{0.0, 0.0}, {steps * run, 0.0}};
+	for (int i = steps; i > 0; --i) {
+		outline.push_back({i * run, i * rise});
+		outline.push_back({(i - 1) * run, i * rise});
+	}
+	return outline;
+}
+
+/**
+ * 梳状多边形：高 base 的底座上立着 teeth 个宽 tooth、高 height 的齿，齿间距 gap
+ */
+Outline comb(int teeth, double base, double gap, double tooth, double height) {
+	double width = teeth * tooth + (teeth - 1) * gap;
+	Outline outline = {{0.0, 0.0}, {width, 0.0}, {width, base + height}};
+	for (int i = teeth - 1; i >= 0; --i) {
+		double x0 = i * (tooth + gap);
+		outline.push_back({x0, base + height});
+		if (i > 0) {
+			outline.push_back({x0, base});
+			outline.push_back({x0 - gap, base});
+			outline.push_back({x0 - gap, base + height});
+		}
+	}
+	return outline;
+}
+
+Outline rotate(const Outline& outline, double angle, double dx, double dy) {
+	double c = std::cos(angle), s = std::sin(angle);
+	Outline result;
+	for (const auto& p : outline) {
+		result.push_back({p.first * c - p.second * s + dx, p.first * s + p.second * c + dy});
+	}
+	return result;
+}
+
+Outline scale(const Outline& outline, double factor) {
+	Outline result;
+	for (const auto& p : outline) {
+		result.push_back({p.first * factor, p.second * factor});
+	}
+	return result;
+}
+
+}
+
+int main()
+{
+	std::mt19937 rng(20240611);
+	char name[64];
+
+	// 网格：随机格子组成的正交多边形
+	for (int i = 0; i < 2000; ++i) {
+		std::snprintf(name, sizeof(name), "grid_%d", i);
+		check(name, randomGrid(rng, 4 + i % 20));
+	}
+
+	// 梳状：大量同时发生的分裂与边消失事件
+	for (int teeth = 2; teeth <= 41; teeth += 3) {
+		for (double base : {0.3, 1.0, 2.0, 5.0}) {
+			for (double gap : {0.5, 1.0, 2.0}) {
+				std::snprintf(name, sizeof(name), "comb_%d_%g_%g", teeth, base, gap);
+				check(name, comb(teeth, base, gap, 1.0, 4.0));
+			}
+		}
+	}
+	for (int steps : {1, 2, 5, 20, 100}) {
+		std::snprintf(name, sizeof(name), "staircase_%d", steps);
+		check(name, staircase(steps, 1.0, 1.0));
+		std::snprintf(name, sizeof(name), "staircase_flat_%d", steps);
+		check(name, staircase(steps, 3.0, 0.5));
+	}
+
+	// 旋转：整体旋转并平移后的正交多边形
+	for (int i = 0; i < 300; ++i) {
+		double angle = 0.1 + i * 0.01;
+		std::snprintf(name, sizeof(name), "rotated_grid_%d", i);
+		check(name, rotate(randomGrid(rng, 6 + i % 10), angle, 3.0, -7.0));
+	}
+	for (double angle : {M_PI / 6, M_PI / 4, 1.0, 2.5}) {
+		std::snprintf(name, sizeof(name), "rotated_comb_%g", angle);
+		check(name, rotate(comb(7, 1.0, 1.0, 1.0, 4.0), angle, 1000.0, 2000.0));
+	}
+
+	// 接近退化：相等边长导致的同时事件、极细的矩形、仅差一点点的台阶、大坐标
+	check("square", {{0, 0}, {1, 0}, {1, 1}, {0, 1}});
+	check("thin_rectangle", {{0, 0}, {100, 0}, {100, 1e-4}, {0, 1e-4}});
+	check("plus", {{1, 0}, {2, 0}, {2, 1}, {3, 1}, {3, 2}, {2, 2}, {2, 3}, {1, 3}, {1, 2}, {0, 2}, {0, 1}, {1, 1}});
+	check("equal_notches", {{0, 0}, {4, 0}, {4, 4}, {3, 4}, {3, 2}, {1, 2}, {1, 4}, {0, 4}});
+	check("near_equal_notches", {{0, 0}, {4, 0}, {4, 4}, {3, 4}, {3, 2 + 1e-7}, {1, 2 + 1e-7}, {1, 4}, {0, 4}});
+	check("tiny_step", {{0, 0}, {10, 0}, {10, 5}, {5 + 1e-6, 5}, {5 + 1e-6, 5 + 1e-6}, {0, 5 + 1e-6}});
+	check("tiny_notch", {{0, 0}, {10, 0}, {10, 4}, {5 + 1e-5, 4}, {5 + 1e-5, 4 - 1e-5}, {5, 4 - 1e-5}, {5, 4}, {0, 4}});
+	for (int i = 0; i < 50; ++i) {
+		std::snprintf(name, sizeof(name), "large_coordinates_%d", i);
+		check(name, rotate(scale(randomGrid(rng, 8), 0.37), 0.0, 500000.0, 4300000.0));
+	}
+
+	std::printf("%d/%d cases passed\n", g_cases - g_failures, g_cases);
+	return g_failures == 0 ? 0 : 1;
+}
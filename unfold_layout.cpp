@@ -0,0 +1,428 @@
+#include "unfold_layout.h"
+#include "logger.h"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+
+namespace RoofOutline {
+
+namespace {
+
+/**
+ * 轴对齐包围盒
+ */
+struct Box {
+    double min_x;
+    double min_y;
+    double max_x;
+    double max_y;
+
+    bool overlaps(const Box& other) const {
+        return min_x <= other.max_x && other.min_x <= max_x &&
+               min_y <= other.max_y && other.min_y <= max_y;
+    }
+
+    double perimeter() const {
+        return 2.0 * ((max_x - min_x) + (max_y - min_y));
+    }
+
+    Box merged(const Box& other) const {
+        return {std::min(min_x, other.min_x), std::min(min_y, other.min_y),
+                std::max(max_x, other.max_x), std::max(max_y, other.max_y)};
+    }
+
+    Box translated(double dx, double dy) const {
+        return {min_x + dx, min_y + dy, max_x + dx, max_y + dy};
+    }
+
+    Box inflated(double amount) const {
+        return {min_x - amount, min_y - amount, max_x + amount, max_y + amount};
+    }
+};
+
+Box boundsOf(const std::vector<std::pair<double, double>>& vertices) {
+    Box box = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+               std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()};
+    for (const auto& v : vertices) {
+        box.min_x = std::min(box.min_x, v.first);
+        box.min_y = std::min(box.min_y, v.second);
+        box.max_x = std::max(box.max_x, v.first);
+        box.max_y = std::max(box.max_y, v.second);
+    }
+    return box;
+}
+
+/**
+ * 增量构建的包围盒层次结构
+ * 插入时沿周长代价最小的路径下降找到兄弟节点（与 Box2D 动态树相同的启发式），随后向上更新包围盒
+ */
+class BoundingVolumeHierarchy {
+public:
+    void insert(const Box& box, int item) {
+        int leaf = allocate(box, item);
+        if (root_ < 0) {
+            root_ = leaf;
+            return;
+        }
+
+        // 选择兄弟节点
+        int index = root_;
+        while (!isLeaf(index)) {
+            const Node& node = nodes_[index];
+            double area = node.box.perimeter();
+            double combined = node.box.merged(box).perimeter();
+            double cost = 2.0 * combined;
+            double inheritance = 2.0 * (combined - area);
+
+            double child_cost[2];
+            for (int i = 0; i < 2; ++i) {
+                const Node& child = nodes_[node.children[i]];
+                double enlarged = child.box.merged(box).perimeter();
+                child_cost[i] = (isLeaf(node.children[i]) ? enlarged : enlarged - child.box.perimeter()) + inheritance;
+            }
+
+            if (cost < child_cost[0] && cost < child_cost[1]) {
+                break;
+            }
+            index = child_cost[0] <= child_cost[1] ? node.children[0] : node.children[1];
+        }
+
+        // 用新的内部节点替换兄弟节点
+        int sibling = index;
+        int old_parent = nodes_[sibling].parent;
+        int parent = allocate(nodes_[sibling].box.merged(box), -1);
+        nodes_[parent].parent = old_parent;
+        nodes_[parent].children[0] = sibling;
+        nodes_[parent].children[1] = leaf;
+        nodes_[sibling].parent = parent;
+        nodes_[leaf].parent = parent;
+
+        if (old_parent < 0) {
+            root_ = parent;
+        } else {
+            Node& node = nodes_[old_parent];
+            node.children[node.children[0] == sibling ? 0 : 1] = parent;
+        }
+
+        // 向上更新包围盒
+        for (int i = old_parent; i >= 0; i = nodes_[i].parent) {
+            Node& node = nodes_[i];
+            node.box = nodes_[node.children[0]].box.merged(nodes_[node.children[1]].box);
+        }
+    }
+
+    /**
+     * 对所有与 box 相交的叶子调用 visitor；visitor 返回 true 时提前结束并返回 true
+     */
+    template <typename Visitor>
+    bool query(const Box& box, Visitor&& visitor) const {
+        if (root_ < 0) {
+            return false;
+        }
+
+        stack_.clear();
+        stack_.push_back(root_);
+        while (!stack_.empty()) {
+            int index = stack_.back();
+            stack_.pop_back();
+
+            const Node& node = nodes_[index];
+            if (!node.box.overlaps(box)) {
+                continue;
+            }
+            if (isLeaf(index)) {
+                if (visitor(node.item)) {
+                    return true;
+                }
+            } else {
+                stack_.push_back(node.children[0]);
+                stack_.push_back(node.children[1]);
+            }
+        }
+        return false;
+    }
+
+private:
+    struct Node {
+        Box box;
+        int parent;
+        int children[2];
+        int item;   // 叶子对应的面序号，内部节点为 -1
+    };
+
+    bool isLeaf(int index) const {
+        return nodes_[index].children[0] < 0;
+    }
+
+    int allocate(const Box& box, int item) {
+        nodes_.push_back({box, -1, {-1, -1}, item});
+        return static_cast<int>(nodes_.size() - 1);
+    }
+
+    std::vector<Node> nodes_;
+    int root_ = -1;
+    mutable std::vector<int> stack_;
+};
+
+double pointSegmentDistanceSquared(
+    double px, double py,
+    double ax, double ay, double bx, double by
+) {
+    double dx = bx - ax;
+    double dy = by - ay;
+    double length_squared = dx * dx + dy * dy;
+    double t = length_squared > 0 ? ((px - ax) * dx + (py - ay) * dy) / length_squared : 0.0;
+    t = std::max(0.0, std::min(1.0, t));
+    double cx = ax + t * dx - px;
+    double cy = ay + t * dy - py;
+    return cx * cx + cy * cy;
+}
+
+bool segmentsIntersect(
+    double ax, double ay, double bx, double by,
+    double cx, double cy, double dx, double dy
+) {
+    double d1 = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+    double d2 = (bx - ax) * (dy - ay) - (by - ay) * (dx - ax);
+    double d3 = (dx - cx) * (ay - cy) - (dy - cy) * (ax - cx);
+    double d4 = (dx - cx) * (by - cy) - (dy - cy) * (bx - cx);
+    return ((d1 > 0) != (d2 > 0)) && ((d3 > 0) != (d4 > 0));
+}
+
+}
+
+bool UnfoldLayout::pointInPolygon(
+    double x, double y,
+    const std::vector<std::pair<double, double>>& polygon
+) {
+    bool inside = false;
+    size_t n = polygon.size();
+    for (size_t i = 0, j = n - 1; i < n; j = i++) {
+        const auto& a = polygon[i];
+        const auto& b = polygon[j];
+        if ((a.second > y) != (b.second > y) &&
+            x < (b.first - a.first) * (y - a.second) / (b.second - a.second) + a.first) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+bool UnfoldLayout::polygonsCloserThan(
+    const std::vector<std::pair<double, double>>& a,
+    const std::vector<std::pair<double, double>>& b,
+    double offset_x, double offset_y,
+    double spacing
+) {
+    double spacing_squared = spacing * spacing;
+    size_t na = a.size();
+    size_t nb = b.size();
+
+    // 边与边相交或距离过近
+    for (size_t i = 0; i < na; ++i) {
+        double ax = a[i].first + offset_x;
+        double ay = a[i].second + offset_y;
+        double bx = a[(i + 1) % na].first + offset_x;
+        double by = a[(i + 1) % na].second + offset_y;
+
+        for (size_t j = 0; j < nb; ++j) {
+            double cx = b[j].first;
+            double cy = b[j].second;
+            double dx = b[(j + 1) % nb].first;
+            double dy = b[(j + 1) % nb].second;
+
+            if (segmentsIntersect(ax, ay, bx, by, cx, cy, dx, dy) ||
+                pointSegmentDistanceSquared(ax, ay, cx, cy, dx, dy) < spacing_squared ||
+                pointSegmentDistanceSquared(cx, cy, ax, ay, bx, by) < spacing_squared) {
+                return true;
+            }
+        }
+    }
+
+    // 边界互不相交时，只可能是一个多边形完全包含另一个
+    if (na > 0 && nb > 0 &&
+        (pointInPolygon(a[0].first + offset_x, a[0].second + offset_y, b) ||
+         pointInPolygon(b[0].first - offset_x, b[0].second - offset_y, a))) {
+        return true;
+    }
+
+    return false;
+}
+
+bool UnfoldLayout::arrange(
+    const SsPtr& skeleton,
+    std::vector<std::pair<std::vector<std::pair<double, double>>, bool>>& unfolded_faces,
+    double spacing
+) {
+    size_t face_count = unfolded_faces.size();
+    if (!skeleton || skeleton->size_of_faces() != face_count) {
+        ROOF_LOG_ERROR("layout", "错误：展开面数量与直骨架不一致，无法排布");
+        return false;
+    }
+    if (face_count == 0) {
+        return true;
+    }
+
+    // 面序号（与 computeUnfoldedFaces 的遍历顺序一致）
+    std::unordered_map<const void*, int> face_index;
+    face_index.reserve(face_count);
+    int next_index = 0;
+    for (auto fit = skeleton->faces_begin(); fit != skeleton->faces_end(); ++fit) {
+        face_index[&*fit] = next_index++;
+    }
+
+    // 邻接关系：共享骨架边的两个面，权重为共享边长度
+    std::vector<std::vector<std::pair<int, double>>> adjacency(face_count);
+    for (auto hit = skeleton->halfedges_begin(); hit != skeleton->halfedges_end(); ++hit) {
+        if (!hit->is_bisector() || !(hit < hit->opposite())) {
+            continue;
+        }
+        int a = face_index[&*hit->face()];
+        int b = face_index[&*hit->opposite()->face()];
+        if (a == b) {
+            continue;
+        }
+        double dx = hit->vertex()->point().x() - hit->opposite()->vertex()->point().x();
+        double dy = hit->vertex()->point().y() - hit->opposite()->vertex()->point().y();
+        double length = std::sqrt(dx * dx + dy * dy);
+        adjacency[a].push_back({b, length});
+        adjacency[b].push_back({a, length});
+    }
+
+    std::vector<Box> bounds(face_count);
+    std::vector<std::pair<double, double>> centroids(face_count);
+    std::vector<double> areas(face_count);
+    for (size_t i = 0; i < face_count; ++i) {
+        const auto& vertices = unfolded_faces[i].first;
+        bounds[i] = boundsOf(vertices);
+
+        double twice_area = 0.0;
+        double cx = 0.0, cy = 0.0;
+        for (size_t k = 0; k < vertices.size(); ++k) {
+            const auto& p = vertices[k];
+            const auto& q = vertices[(k + 1) % vertices.size()];
+            double cross = p.first * q.second - q.first * p.second;
+            twice_area += cross;
+            cx += (p.first + q.first) * cross;
+            cy += (p.second + q.second) * cross;
+        }
+        areas[i] = std::abs(twice_area) * 0.5;
+        if (std::abs(twice_area) > 0) {
+            centroids[i] = {cx / (3.0 * twice_area), cy / (3.0 * twice_area)};
+        } else {
+            centroids[i] = {(bounds[i].min_x + bounds[i].max_x) * 0.5, (bounds[i].min_y + bounds[i].max_y) * 0.5};
+        }
+    }
+
+    // 放置顺序：从面积最大的面开始，每次放置与已放置面共享边最长的面（最大生成树），
+    // 使相邻面在展开图中尽量保持相邻
+    std::vector<std::pair<double, double>> offsets(face_count, {0.0, 0.0});
+    std::vector<int> parent(face_count, -1);
+    std::vector<bool> placed(face_count, false);
+    std::priority_queue<std::pair<double, std::pair<int, int>>> frontier;
+
+    BoundingVolumeHierarchy hierarchy;
+    size_t exact_tests = 0;
+
+    auto collides = [&](int face, double offset_x, double offset_y) {
+        Box box = bounds[face].translated(offset_x, offset_y).inflated(spacing);
+        return hierarchy.query(box, [&](int other) {
+            ++exact_tests;
+            return polygonsCloserThan(unfolded_faces[face].first, unfolded_faces[other].first,
+                                      offset_x, offset_y, spacing);
+        });
+    };
+
+    auto place = [&](int face) {
+        // 初始位置沿用父面的平移量，保持两面原有的相对位置
+        double base_x = 0.0, base_y = 0.0;
+        double dir_x = 0.0, dir_y = 0.0;
+        if (parent[face] >= 0) {
+            int p = parent[face];
+            base_x = offsets[p].first;
+            base_y = offsets[p].second;
+            dir_x = centroids[face].first + base_x - centroids[p].first;
+            dir_y = centroids[face].second + base_y - centroids[p].second;
+        }
+        double dir_length = std::sqrt(dir_x * dir_x + dir_y * dir_y);
+        if (dir_length > 0) {
+            dir_x /= dir_length;
+            dir_y /= dir_length;
+        } else {
+            dir_x = 0.0;
+            dir_y = 1.0;
+        }
+
+        // 沿远离父面的方向推开：先倍增步长找到无碰撞位置，再二分收紧间距
+        double distance = 0.0;
+        if (collides(face, base_x, base_y)) {
+            double low = 0.0;
+            double high = std::max(spacing, 1e-9);
+            int doublings = 0;
+            while (collides(face, base_x + dir_x * high, base_y + dir_y * high) && doublings < 64) {
+                low = high;
+                high *= 2.0;
+                ++doublings;
+            }
+            for (int i = 0; i < 16 && high - low > spacing * 0.05; ++i) {
+                double middle = 0.5 * (low + high);
+                if (collides(face, base_x + dir_x * middle, base_y + dir_y * middle)) {
+                    low = middle;
+                } else {
+                    high = middle;
+                }
+            }
+            distance = high;
+        }
+
+        offsets[face] = {base_x + dir_x * distance, base_y + dir_y * distance};
+        placed[face] = true;
+
+        auto& vertices = unfolded_faces[face].first;
+        for (auto& v : vertices) {
+            v.first += offsets[face].first;
+            v.second += offsets[face].second;
+        }
+        bounds[face] = bounds[face].translated(offsets[face].first, offsets[face].second);
+        centroids[face].first += offsets[face].first;
+        centroids[face].second += offsets[face].second;
+        hierarchy.insert(bounds[face], face);
+
+        for (const auto& [neighbor, length] : adjacency[face]) {
+            if (!placed[neighbor]) {
+                frontier.push({length, {neighbor, face}});
+            }
+        }
+    };
+
+    // 可能存在多个互不相连的面组，每组各自从最大的面开始
+    std::vector<int> by_area(face_count);
+    for (size_t i = 0; i < face_count; ++i) {
+        by_area[i] = static_cast<int>(i);
+    }
+    std::sort(by_area.begin(), by_area.end(), [&areas](int a, int b) { return areas[a] > areas[b]; });
+
+    for (int root : by_area) {
+        if (placed[root]) {
+            continue;
+        }
+        place(root);
+        while (!frontier.empty()) {
+            auto [length, link] = frontier.top();
+            frontier.pop();
+            int face = link.first;
+            if (placed[face]) {
+                continue;
+            }
+            parent[face] = link.second;
+            place(face);
+        }
+    }
+
+    ROOF_LOG_DEBUG("layout", "展开面排布完成：%zu 个面，精确碰撞检测 %zu 次", face_count, exact_tests);
+    return true;
+}
+
+}
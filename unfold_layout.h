@@ -0,0 +1,49 @@
+#pragma once
+
+#include "types.h"
+#include <vector>
+#include <utility>
+
+namespace RoofOutline {
+
+/**
+ * 展开图排布模块
+ * 沿屋面邻接关系逐个平移放置展开后的面，保证面与面之间互不重叠且至少相隔指定间距。
+ * 已放置的面保存在包围盒层次结构（BVH）中，每次碰撞检测只与包围盒相交的少数面做精确比较
+ */
+class UnfoldLayout {
+public:
+    /**
+     * 排布展开后的面（只做平移，不改变面的形状和朝向）
+     * @param skeleton 直骨架（用于确定面之间的邻接关系）
+     * @param unfolded_faces 展开后的面，顺序与直骨架的面一致，结果原地写回
+     * @param spacing 面之间的最小间距（与面坐标同单位）
+     * @return 是否成功（面数与直骨架不一致时返回 false 且不修改输入）
+     */
+    static bool arrange(
+        const SsPtr& skeleton,
+        std::vector<std::pair<std::vector<std::pair<double, double>>, bool>>& unfolded_faces,
+        double spacing
+    );
+
+private:
+    /**
+     * 判断两个多边形是否重叠或距离小于 spacing
+     */
+    static bool polygonsCloserThan(
+        const std::vector<std::pair<double, double>>& a,
+        const std::vector<std::pair<double, double>>& b,
+        double offset_x, double offset_y,
+        double spacing
+    );
+
+    /**
+     * 判断点是否在多边形内部（偶奇规则）
+     */
+    static bool pointInPolygon(
+        double x, double y,
+        const std::vector<std::pair<double, double>>& polygon
+    );
+};
+
+}